@@ -8,6 +8,12 @@ QT  += core gui multimedia
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
+# qmake CONFIG+=single_precision: próbki i widmo w typie float (fftwf). Wymaga biblioteki fftw3f,
+# na Windows libfftw3f-3.lib i libfftw3f-3.dll w katalogu lib.
+single_precision {
+	DEFINES += KK_SINGLE_PRECISION
+}
+
 TARGET = kk
 TEMPLATE = app
 QMAKE_CXXFLAGS += -std=c++11 # for MinGW
@@ -15,11 +21,13 @@ QMAKE_CXXFLAGS += -std=c++11 # for MinGW
 linux-g++ {
 	CONFIG += link_pkgconfig
 	PKGCONFIG += fftw3
+	single_precision: PKGCONFIG += fftw3f
 }
 
 win32 {
 	DESTDIR = $$PWD
 	LIBS += -L$$DESTDIR\lib -llibfftw3-3
+	single_precision: LIBS += -llibfftw3f-3
 	INCLUDEPATH = $$DESTDIR\lib
 }
 
@@ -30,7 +38,32 @@ SOURCES += src/main.cpp \
     src/userwindow.cpp \
     src/adduserwindow.cpp \
 	src/calibrator.cpp \
-    src/audiomodel.cpp
+    src/audiomodel.cpp \
+    src/fftplancache.cpp \
+    src/weightingtable.cpp \
+    src/levelanalyzer.cpp \
+    src/aweightingfilter.cpp \
+    src/benchmark.cpp \
+    src/audiosink.cpp \
+    src/levelmeter.cpp \
+    src/pcmconverter.cpp \
+    src/analysisworker.cpp \
+    src/wavreader.cpp \
+    src/wavFile.cpp \
+    src/archivewriter.cpp \
+    src/losslesscodec.cpp \
+    src/compressedaudiofile.cpp \
+    src/resampler.cpp \
+    src/recordinglane.cpp \
+    src/calibrationprofiles.cpp \
+    src/stabilitydetector.cpp \
+    src/tonedetector.cpp \
+    src/frequencyresponse.cpp \
+    src/responsemeter.cpp \
+    src/rankingindex.cpp \
+    src/rankingmodel.cpp \
+    src/participanttablemodel.cpp \
+    src/participantstore.cpp
 
 HEADERS  += \
     src/recorder.h \
@@ -39,7 +72,35 @@ HEADERS  += \
     src/userwindow.h \
     src/adduserwindow.h \
     src/audiomodel.h \
-    src/calibrator.h
+    src/calibrator.h \
+    src/fftplancache.h \
+    src/weightingtable.h \
+    src/levelanalyzer.h \
+    src/aweightingfilter.h \
+    src/levelmetrics.h \
+    src/benchmark.h \
+    src/ringbuffer.h \
+    src/sampleconsumer.h \
+    src/audiosink.h \
+    src/levelmeter.h \
+    src/pcmconverter.h \
+    src/analysisworker.h \
+    src/wavreader.h \
+    src/wavFile.h \
+    src/archivewriter.h \
+    src/losslesscodec.h \
+    src/compressedaudiofile.h \
+    src/resampler.h \
+    src/recordinglane.h \
+    src/calibrationprofiles.h \
+    src/stabilitydetector.h \
+    src/tonedetector.h \
+    src/frequencyresponse.h \
+    src/responsemeter.h \
+    src/rankingindex.h \
+    src/rankingmodel.h \
+    src/participanttablemodel.h \
+    src/participantstore.h
 
 
 FORMS += \
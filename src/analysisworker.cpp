@@ -0,0 +1,131 @@
+#include "analysisworker.h"
+#include <QScopedPointer>
+#include "resampler.h"
+
+/**
+ * @brief Konstruktor. Rejestruje analizator, miernik, detektory stabilności i tonu kalibracyjnego oraz pomiar charakterystyki
+ * jako odbiorców próbek urządzenia.
+ * @param sink Urządzenie, do którego zapisywane jest nagranie.
+ * @param parent Obiekt nadrzędny.
+ */
+AnalysisWorker::AnalysisWorker(AudioSink *sink, QObject *parent) : QObject(parent), sink(sink), meter(this),
+	stability(this), tone(this), block(AudioSink::blockSize)
+{
+	sink->addConsumer(&analyzer);
+	sink->addConsumer(&meter);
+	sink->addConsumer(&stability);
+	sink->addConsumer(&tone);
+	sink->addConsumer(&response);
+	sink->addConsumer(&archive);
+	connect(&meter, SIGNAL(levelChanged(double)), this, SIGNAL(levelChanged(double)));
+	connect(&stability, SIGNAL(stabilised()), this, SIGNAL(stabilised()));
+	connect(&tone, SIGNAL(toneMissing()), this, SIGNAL(toneMissing()));
+}
+/**
+ * @brief Slot przygotowujący analizator, miernik, detektory i archiwum do nowego nagrania.
+ * @param archiveFile Nazwa pliku archiwum; pusta, jeśli nagranie nie ma być zapisane.
+ * @param leadIn Liczba próbek bufora wyprzedzenia na początku nagrania (AudioSink::leadIn()). Trafiają do archiwum i pozostałych
+ * odbiorców, ale nie do wyniku.
+ * @param engine Metoda liczenia głośności wybrana w wątku interfejsu w chwili rozpoczęcia nagrania.
+ */
+void AnalysisWorker::begin(const QString &archiveFile, int leadIn, AudioModel::Engine engine)
+{
+	analyzer.reset();
+	analyzer.setLeadIn(leadIn);
+	analyzer.setEngine(engine);
+	meter.reset();
+	stability.reset();
+	tone.reset();
+	response.reset();
+	archive.begin(archiveFile);
+}
+/**
+ * @brief Slot analizujący wszystkie pełne bloki zgromadzone w urządzeniu.
+ */
+void AnalysisWorker::drain()
+{
+	sink->deliver();
+}
+/**
+ * @brief Slot kończący nagranie: analizuje pozostałe próbki i wysyła wyniki.
+ */
+void AnalysisWorker::end()
+{
+	sink->deliver(true);
+	archive.end();
+	emit stabilityMeasured(stability.level(), stability.deviation(), stability.isStable());
+	emit toneMeasured(tone.result());
+	if (response.isEnabled())
+		emit responseMeasured(response.finish());
+	emit finished(analyzer.finish());
+}
+/**
+ * @brief Slot ustawiający kryterium, po spełnieniu którego wysyłany jest sygnał stabilised(). Obowiązuje do następnego wywołania.
+ * @param tolerance Dopuszczalne odchylenie poziomu w decybelach; 0 wyłącza sygnał.
+ * @param holdMilliseconds Czas, przez który poziom musi mieścić się w tolerancji.
+ */
+void AnalysisWorker::setStabilityTarget(double tolerance, int holdMilliseconds)
+{
+	stability.setTarget(tolerance, holdMilliseconds);
+}
+/**
+ * @brief Slot ustawiający, czy brak tonu kalibracyjnego na początku nagrania ma być zgłaszany sygnałem toneMissing().
+ * Obowiązuje do następnego wywołania.
+ * @param required true, jeśli nagranie musi zawierać ton kalibracyjny.
+ */
+void AnalysisWorker::setToneRequired(bool required)
+{
+	tone.setRequired(required);
+}
+/**
+ * @brief Slot włączający pomiar charakterystyki częstotliwościowej w kolejnych nagraniach. Obowiązuje do następnego wywołania.
+ * @param enabled true, jeśli nagrania są sygnałem pomiarowym charakterystyki.
+ */
+void AnalysisWorker::setResponseMeasurement(bool enabled)
+{
+	response.setEnabled(enabled);
+}
+/**
+ * @brief Slot ustawiający krzywą korekcji urządzenia, uwzględnianą od następnego nagrania (także z pliku).
+ * @param response Krzywa korekcji; pusty wskaźnik wyłącza korekcję.
+ */
+void AnalysisWorker::setResponse(const QSharedPointer<const FrequencyResponse> &response)
+{
+	analyzer.setResponse(response);
+}
+/**
+ * @brief Slot analizujący nagranie z pliku. Próbki są zamieniane blokami wprost z widoku zmapowanego pliku, a jeśli plik ma inną
+ * częstotliwość próbkowania niż AudioModel::sampleRate(), przepróbkowywane.
+ * @param reader Otwarty plik WAV.
+ * @param engine Metoda liczenia głośności wybrana w wątku interfejsu.
+ */
+void AnalysisWorker::analyse(const QSharedPointer<WavReader> &reader, AudioModel::Engine engine)
+{
+	analyzer.reset();
+	analyzer.setEngine(engine);
+	tone.reset();
+	QScopedPointer<Resampler> resampler;
+	QVector<Sample> resampled;
+	if (reader->sampleRate() != AudioModel::sampleRate())
+	{
+		resampler.reset(new Resampler(reader->sampleRate(), AudioModel::sampleRate()));
+		resampled.resize(resampler->maxOutput(AudioSink::blockSize));
+	}
+	const int count = reader->frames();
+	for (int done = 0; done < count; done += AudioSink::blockSize)
+	{
+		const int n = qMin(AudioSink::blockSize, count - done);
+		reader->read(done, n, block.data());
+		const Sample *samples = block.constData();
+		int produced = n;
+		if (!resampler.isNull())
+		{
+			produced = resampler->process(block.constData(), n, resampled.data());
+			samples = resampled.constData();
+		}
+		analyzer.process(samples, produced);
+		tone.consume(samples, produced);
+	}
+	emit toneMeasured(tone.result());
+	emit finished(analyzer.finish());
+}
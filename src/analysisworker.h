@@ -0,0 +1,81 @@
+#ifndef ANALYSISWORKER_H
+#define ANALYSISWORKER_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+#include "archivewriter.h"
+#include "audiosink.h"
+#include "levelanalyzer.h"
+#include "levelmeter.h"
+#include "responsemeter.h"
+#include "stabilitydetector.h"
+#include "tonedetector.h"
+#include "wavreader.h"
+
+/**
+ * @brief Obiekt wykonujący całą analizę nagrania w osobnym wątku (Recorder przenosi go do swojego QThread). Odbiera bloki
+ * próbek z AudioSink jako jej jedyny konsument, a wyniki zwraca sygnałami, które do wątku interfejsu trafiają przez kolejkę zdarzeń.
+ * Wątek interfejsu nie wykonuje więc ani transformat, ani filtrowania.
+ */
+class AnalysisWorker : public QObject
+{
+	Q_OBJECT
+	AudioSink *sink;
+	LevelAnalyzer analyzer;
+	LevelMeter meter;
+	StabilityDetector stability;
+	ToneDetector tone;
+	ResponseMeter response;
+	ArchiveWriter archive;
+	QVector<Sample> block;
+public:
+	explicit AnalysisWorker(AudioSink *sink, QObject *parent = nullptr);
+public slots:
+	void begin(const QString &archiveFile = QString(), int leadIn = 0, AudioModel::Engine engine = AudioModel::FftEngine);
+	void drain();
+	void end();
+	void setStabilityTarget(double tolerance, int holdMilliseconds);
+	void setToneRequired(bool required);
+	void setResponseMeasurement(bool enabled);
+	void setResponse(const QSharedPointer<const FrequencyResponse> &response);
+	void analyse(const QSharedPointer<WavReader> &reader, AudioModel::Engine engine = AudioModel::FftEngine);
+signals:
+	/**
+	 * @brief Sygnał z wynikami zakończonego nagrania.
+	 * @param metrics Miary głośności w decybelach (bez danych kalibracyjnych).
+	 */
+	void finished(const LevelMetrics &metrics);
+	/**
+	 * @brief Sygnał z bieżącym poziomem w trakcie nagrywania.
+	 * @param level Poziom z charakterystyką A i uśrednianiem Fast w decybelach (bez danych kalibracyjnych).
+	 */
+	void levelChanged(double level);
+	/**
+	 * @brief Sygnał wysyłany, gdy poziom nagrania ustali się w tolerancji ustawionej przez setStabilityTarget().
+	 */
+	void stabilised();
+	/**
+	 * @brief Sygnał ze stabilnością zakończonego nagrania, wysyłany tuż przed finished().
+	 * @param level Poziom okna, w którym sygnał się ustalił (albo ostatniego okna) w decybelach, bez danych kalibracyjnych.
+	 * @param deviation Największe odchylenie poziomu odcinka od poziomu okna w decybelach.
+	 * @param stable true, jeśli poziom ustalił się w zadanej tolerancji.
+	 */
+	void stabilityMeasured(double level, double deviation, bool stable);
+	/**
+	 * @brief Sygnał wysyłany na początku nagrania, w którym wymagany jest ton kalibracyjny, a nie został wykryty.
+	 */
+	void toneMissing();
+	/**
+	 * @brief Sygnał z wynikiem sprawdzenia tonu kalibracyjnego, wysyłany po każdym nagraniu (także z pliku) tuż przed finished().
+	 * @param tone Częstotliwość, czystość i poziom tonu.
+	 */
+	void toneMeasured(const ToneCheck &tone);
+	/**
+	 * @brief Sygnał z krzywą korekcji zmierzoną w nagraniu, wysyłany tuż przed finished(), jeśli włączono pomiar charakterystyki.
+	 * @param response Krzywa korekcji; pusty wskaźnik, jeśli w nagraniu nie było sygnału pomiarowego.
+	 */
+	void responseMeasured(const QSharedPointer<const FrequencyResponse> &response);
+};
+
+#endif // ANALYSISWORKER_H
@@ -0,0 +1,205 @@
+#include "archivewriter.h"
+#include <QAudioFormat>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief Rozmiar paczki przekazywanej do wątku zapisu, w próbkach (ok. 1,4 s przy 48 kHz).
+ */
+static const int batchSamples = 16 * 4096;
+/**
+ * @brief Zwraca ścieżkę nieistniejącego jeszcze pliku w katalogu archiwum sesji: podaną nazwę albo, jeśli plik już istnieje,
+ * nazwę z kolejnym numerem (np. plik_2.kka).
+ * @param baseName Nazwa pliku bez rozszerzenia.
+ * @param suffix Rozszerzenie pliku (bez kropki).
+ * @return Pełna ścieżka pliku.
+ */
+static QString unusedFileName(const QString &baseName, const QString &suffix)
+{
+	QDir directory(ArchiveWriter::sessionDirectory());
+	QString path = directory.filePath(baseName + "." + suffix);
+	for (int copy = 2; QFile::exists(path); ++copy)
+		path = directory.filePath(QString("%1_%2.%3").arg(baseName).arg(copy).arg(suffix));
+	return path;
+}
+
+/**
+ * @brief Slot tworzący plik archiwum i zapisujący jego nagłówek. Istniejący plik nie jest nadpisywany, a nagranie nie jest wtedy archiwizowane.
+ * @param fileName Nazwa pliku.
+ * @param sampleRate Częstotliwość próbkowania w Hz.
+ */
+void ArchiveFileTask::open(const QString &fileName, int sampleRate)
+{
+	close();
+	if (QFile::exists(fileName))
+	{
+		qDebug() << "Archive file already exists, not overwriting" << fileName;
+		return;
+	}
+	QAudioFormat format;
+	format.setChannelCount(1);
+	format.setSampleRate(sampleRate);
+	format.setCodec("audio/pcm");
+	format.setSampleSize(16);
+	format.setByteOrder(QAudioFormat::LittleEndian);
+	format.setSampleType(QAudioFormat::SignedInt);
+	if (fileName.endsWith(".kka", Qt::CaseInsensitive))
+	{
+		auto compressed = new CompressedAudioFile;
+		compressed->setAudioFormat(format);
+		compressed->setFileName(fileName);
+		file.reset(compressed);
+	}
+	else
+	{
+		auto wav = new WavFile;
+		wav->setAudioFormat(format);
+		wav->setFileName(fileName);
+		file.reset(wav);
+	}
+	name = fileName;
+	if (!file->open(QIODevice::WriteOnly))
+	{
+		qDebug() << "Could not create archive file" << fileName << file->errorString();
+		file.reset();
+	}
+}
+/**
+ * @brief Slot dopisujący paczkę próbek do pliku.
+ * @param data Próbki PCM, 16 bitów, little endian.
+ */
+void ArchiveFileTask::write(const QByteArray &data)
+{
+	if (!file.isNull() && file->write(data) != data.size())
+		qDebug() << "Could not write archive file" << name << file->errorString();
+}
+/**
+ * @brief Slot uzupełniający rozmiary w nagłówku i zamykający plik.
+ */
+void ArchiveFileTask::close()
+{
+	if (!file.isNull())
+		file->close();
+	file.reset();
+}
+
+/**
+ * @brief Konstruktor. Uruchamia wątek zapisu.
+ */
+ArchiveWriter::ArchiveWriter() : task(new ArchiveFileTask), active(false)
+{
+	task->moveToThread(&thread);
+	QObject::connect(&thread, SIGNAL(finished()), task, SLOT(deleteLater()));
+	thread.start(QThread::LowPriority);
+}
+/**
+ * @brief Destruktor. Kończy bieżący plik i czeka na zakończenie zapisu.
+ */
+ArchiveWriter::~ArchiveWriter()
+{
+	end();
+	thread.quit();
+	thread.wait();
+}
+/**
+ * @brief Metoda rozpoczynająca nowy plik archiwum.
+ * @param fileName Nazwa pliku; pusta, jeśli nagranie nie ma być archiwizowane.
+ */
+void ArchiveWriter::begin(const QString &fileName)
+{
+	end();
+	if (fileName.isEmpty())
+		return;
+	active = true;
+	batch.reserve(batchSamples * (int) sizeof(qint16));
+	QMetaObject::invokeMethod(task, "open", Q_ARG(QString, fileName), Q_ARG(int, AudioModel::sampleRate()));
+}
+/**
+ * @brief Metoda dopisująca próbki do bieżącej paczki i przekazująca pełną paczkę do wątku zapisu.
+ * @param samples Próbki sygnału (w zakresie [-1,1]).
+ * @param count Liczba próbek.
+ */
+void ArchiveWriter::consume(const Sample *samples, int count)
+{
+	if (!active)
+		return;
+	const int offset = batch.size();
+	batch.resize(offset + count * (int) sizeof(qint16));
+	qint16 *out = reinterpret_cast<qint16 *>(batch.data() + offset);
+	for (int i = 0; i < count; ++i)
+	{
+		// Exact for 16-bit input at 48 kHz; wider or resampled captures are quantised to 16 bits here.
+		const int value = qRound(samples[i] * std::numeric_limits<short>::max());
+		out[i] = qToLittleEndian<qint16>((qint16) std::max<int>(std::numeric_limits<short>::min(),
+																	 std::min<int>(std::numeric_limits<short>::max(), value)));
+	}
+	if (batch.size() >= batchSamples * (int) sizeof(qint16))
+		flush();
+}
+/**
+ * @brief Metoda przekazująca zebraną paczkę do wątku zapisu.
+ */
+void ArchiveWriter::flush()
+{
+	if (batch.isEmpty())
+		return;
+	QMetaObject::invokeMethod(task, "write", Q_ARG(QByteArray, batch));
+	// The writer thread now shares the old buffer; start a new one.
+	batch = QByteArray();
+	batch.reserve(batchSamples * (int) sizeof(qint16));
+}
+/**
+ * @brief Metoda kończąca bieżący plik archiwum.
+ */
+void ArchiveWriter::end()
+{
+	if (!active)
+		return;
+	flush();
+	QMetaObject::invokeMethod(task, "close");
+	active = false;
+}
+/**
+ * @brief Zwraca katalog archiwum bieżącej sesji (uruchomienia programu), tworząc go przy pierwszym użyciu.
+ * @return Ścieżka katalogu.
+ */
+QString ArchiveWriter::sessionDirectory()
+{
+	static QString directory;
+	if (directory.isEmpty())
+	{
+		QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+		if (dir.isEmpty())
+			dir = QCoreApplication::applicationDirPath();
+		directory = QDir(dir).filePath("archiwum/" + QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss"));
+		QDir().mkpath(directory);
+	}
+	return directory;
+}
+/**
+ * @brief Zwraca nazwę pliku archiwum dla podejścia uczestnika. Nazwa zawiera trwałe ID uczestnika, więc nie zmienia się po usunięciu
+ * lub posortowaniu wierszy listy; jeśli plik już istnieje (np. ponowne nagranie tego samego podejścia), dostaje kolejny numer.
+ * @param participant ID uczestnika w ParticipantStore.
+ * @param attempt Numer podejścia (od 1).
+ * @return Pełna ścieżka pliku.
+ */
+QString ArchiveWriter::attemptFileName(ParticipantStore::Id participant, int attempt)
+{
+	return unusedFileName(QString("uczestnik_%1_podejscie_%2").arg(participant).arg(attempt), "kka");
+}
+/**
+ * @brief Zwraca nazwę pliku archiwum dla kolejnej kalibracji w tej sesji.
+ * @return Pełna ścieżka pliku.
+ */
+QString ArchiveWriter::calibrationFileName()
+{
+	static int calibrations = 0;
+	return unusedFileName(QString("kalibracja_%1").arg(++calibrations), "kka");
+}
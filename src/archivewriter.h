@@ -0,0 +1,57 @@
+#ifndef ARCHIVEWRITER_H
+#define ARCHIVEWRITER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QScopedPointer>
+#include <QString>
+#include <QThread>
+#include "sampleconsumer.h"
+#include "compressedaudiofile.h"
+#include "participantstore.h"
+#include "wavFile.h"
+
+/**
+ * @brief Obiekt zapisujący plik archiwum w wątku zapisu ArchiveWriter. Wszystkie operacje na dysku wykonywane są tutaj.
+ * Pliki *.kka zapisywane są jako CompressedAudioFile, pozostałe jako WavFile.
+ */
+class ArchiveFileTask : public QObject
+{
+	Q_OBJECT
+	QScopedPointer<QIODevice> file;
+	QString name;
+public slots:
+	void open(const QString &fileName, int sampleRate);
+	void write(const QByteArray &data);
+	void close();
+};
+
+/**
+ * @brief Odbiorca próbek zapisujący każde nagranie (PCM, 16 bitów) do pliku w katalogu archiwum bieżącej sesji,
+ * domyślnie skompresowanego bezstratnie (CompressedAudioFile).
+ * Archiwum zawiera sygnał analizy, czyli 48 kHz i 16 bitów, a nie surowe próbki urządzenia: nagranie w innej częstotliwości lub
+ * z większą rozdzielczością jest przepróbkowane i zaokrąglone do 16 bitów, więc kompresja jest bezstratna tylko względem sygnału analizy.
+ * Próbki są zbierane w paczki i przekazywane do osobnego wątku zapisu, więc opóźnienia dysku nie wpływają ani na nagrywanie,
+ * ani na analizę. Nagłówek pliku uzupełniany jest po zakończeniu nagrania.
+ */
+class ArchiveWriter : public SampleConsumer
+{
+	QThread thread;
+	ArchiveFileTask *task;
+	QByteArray batch;
+	bool active;
+
+	void flush();
+public:
+	ArchiveWriter();
+	~ArchiveWriter();
+	void begin(const QString &fileName);
+	void consume(const Sample *samples, int count) override;
+	void end();
+
+	static QString sessionDirectory();
+	static QString attemptFileName(ParticipantStore::Id participant, int attempt);
+	static QString calibrationFileName();
+};
+
+#endif // ARCHIVEWRITER_H
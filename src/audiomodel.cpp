@@ -1,10 +1,14 @@
 #define _USE_MATH_DEFINES
 
 #include "audiomodel.h"
-#include <fftw3.h>
+#include "fftplancache.h"
+#include "weightingtable.h"
 #include <cmath>
+#include <algorithm>
+#include <limits>
 /**
  *  @brief Metoda korzystająca z szybkiej transformaty Fourier'a, która zwraca FFT tablicy liczb zespolonych.
+ *  Plan transformaty pobierany jest z FftPlanCache, więc kolejne wyniki o tym samym rozmiarze nie tworzą planu od nowa.
  *  @param  x tablica liczb zespolonych
  *  @return Zwraca FFT tablicy liczb zespolonych <tt>x</tt>
  * @authors Adrian Borucki Magdalena Buczyńska Adrianna Łuczak Kamil Wasilewski
@@ -13,46 +17,201 @@ QVector<complex<double> > AudioModel::fft(const QVector<complex<double> > &x)
 {
     int N = x.length();
 
-    fftw_complex *in, *out;
-    fftw_plan p;
-    in = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * N);
-    out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * N);
-    p = fftw_plan_dft_1d(N, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
+    // Plan i wyrównane bufory pochodzą z pamięci podręcznej, więc są tworzone tylko raz dla danego rozmiaru.
+    FftPlanCache::Lease plan(N, FftPlanCache::ComplexForward);
+    fftw_complex *in = plan.complexIn();
+    fftw_complex *out = plan.complexOut();
 
     for (int i = 0; i < N; i++) {
         in[i][0] = x[i].real();
         in[i][1] = x[i].imag();
     }
 
-    fftw_execute(p);
+    plan.execute();
 
     auto y = QVector<complex<double>>(N);
     for (int i = 0; i < N; i++) {
         y[i] = complex<double>(out[i][0], out[i][1]);
     }
-
-    fftw_destroy_plan(p);
-    fftw_free(in);
-    fftw_free(out);
 	return y;
 }
 /**
- *  @brief Metoda obliczająca charakterystykę A
- *  @param  frequency częstotliwość
- *  @return zwraca licznik podzielony przez mianownik
- * @authors Kamil Wasilewski
+ *  @param currentEngine Wybrana metoda liczenia głośności. Domyślnie FFT.
+ */
+AudioModel::Engine AudioModel::currentEngine = AudioModel::FftEngine;
+/**
+ *  @brief Metoda wybierająca metodę liczenia głośności używaną przez computeLevel i kolejne nagrania. Wywoływana tylko w wątku interfejsu;
+ *  wątki analizy jej nie odczytują, bo Recorder przekazuje wybraną metodę do AnalysisWorker razem z początkiem nagrania.
+ *  @param engine Metoda liczenia głośności.
+ */
+void AudioModel::setEngine(Engine engine)
+{
+	currentEngine = engine;
+}
+/**
+ *  @brief Zwraca wybraną metodę liczenia głośności.
+ *  @return Metoda liczenia głośności.
+ */
+AudioModel::Engine AudioModel::engine()
+{
+	return currentEngine;
+}
+/**
+ *  @brief Metoda sumująca energię prążków widma z charakterystyką A (IEC 61672, dla rzeczywistej częstotliwości każdego prążka) przy pomocy twierdzenia Parsevala.
+ *  @param xdft Pierwsze samples / 2 + 1 prążków widma sygnału
+ *  @param samples Liczba próbek sygnału, z którego policzono widmo
+ *  @return Energia sygnału z charakterystyką A (suma kwadratów próbek).
+ */
+double AudioModel::weightedEnergy(const complex<double> *xdft, int samples)
+{
+	// Wagi charakterystyki A razem ze skalowaniem Parsevala są wyliczane raz dla danego rozmiaru i częstotliwości próbkowania.
+	auto table = WeightingTable::get(f, samples);
+	// fftw_complex is layout-compatible with std::complex<double>.
+	return spectrumEnergy(reinterpret_cast<const fftw_complex *>(xdft), *table);
+}
+/**
+ *  @brief Metoda sumująca energię prążków widma pomnożonych przez wagi tablicy charakterystyki A.
+ *  @param xdft Pierwsze table.bins() prążków widma sygnału
+ *  @param table Tablica wag dla rozmiaru transformaty, z której pochodzi widmo
+ *  @return Energia sygnału z charakterystyką A (suma kwadratów próbek).
  */
-double AudioModel::filterA(double frequency)
+double AudioModel::spectrumEnergy(const fftw_complex *xdft, const WeightingTable &table)
 {
-	const double c1 = std::pow(12194.217, 2);
-	const double c2 = std::pow(20.598997, 2);
-	const double c3 = std::pow(107.65265, 2);
-	const double c4 = std::pow(737.86223, 2);
-    //kwadrat częstotliwości
-	double f = frequency * frequency;
-	double numerator = f * f * c1; // 'licznik'
-	double denominator = (f + c2) * std::sqrt((f + c3) * (f + c4)) * (f + c1); // 'mianownik'
-	return numerator / denominator;
+	const double *weights = table.data();
+	const int bins = table.bins();
+
+	double total_p = 0.0;
+    //w pętli sumujemy kwadraty modułów prążków pomnożone przez ich wagi
+	for (int i = 0; i < bins; ++i)
+		total_p += weights[i] * (xdft[i][0] * xdft[i][0] + xdft[i][1] * xdft[i][1]);
+	return total_p;
+}
+/**
+ *  @brief Metoda obliczająca energię z charakterystyką A fragmentu sygnału rzeczywistego, uzupełnionego zerami do rozmiaru transformaty.
+ *  Energie kolejnych ramek można sumować.
+ *  @param x Próbki sygnału (w zakresie [-1,1])
+ *  @param count Liczba próbek
+ *  @param size Rozmiar transformaty, nie mniejszy niż count
+ *  @param response Krzywa korekcji urządzenia, uwzględniana w tej samej tablicy wag; pusty wskaźnik bez korekcji
+ *  @return Energia fragmentu z charakterystyką A.
+ */
+double AudioModel::frameEnergy(const double *x, int count, int size, const QSharedPointer<const FrequencyResponse> &response)
+{
+	FftPlanCache::Lease plan(size, FftPlanCache::RealForward);
+	double *in = plan.realIn();
+	std::copy(x, x + count, in);
+	std::fill(in + count, in + size, 0.0);
+	plan.execute();
+	return spectrumEnergy(plan.complexOut(), *WeightingTable::get(f, size, response));
+}
+/**
+ *  @brief Wersja frameEnergy dla analizy strumieniowej: plan przypięty przez wywołującego i tablica wag pobrana przez niego raz,
+ *  więc obliczenie nie blokuje żadnego muteksu i może przebiegać jednocześnie w wątkach kilku stanowisk.
+ *  @param x Próbki sygnału (w zakresie [-1,1])
+ *  @param count Liczba próbek, nie większa niż transform.size()
+ *  @param transform Plan rodzaju RealForward z własnymi buforami
+ *  @param table Tablica wag dla rozmiaru transform.size()
+ *  @return Energia fragmentu z charakterystyką A.
+ */
+double AudioModel::frameEnergy(const double *x, int count, const FftPlanCache::Binding &transform, const WeightingTable &table)
+{
+	double *in = transform.realIn();
+	std::copy(x, x + count, in);
+	std::fill(in + count, in + transform.size(), 0.0);
+	transform.execute();
+	return spectrumEnergy(transform.complexOut(), table);
+}
+#ifdef KK_SINGLE_PRECISION
+/**
+ *  @brief Wersja spectrumEnergy w pojedynczej precyzji: wagi WeightingTable::floatData i sumowanie w typie float.
+ *  Suma prążków liczona jest z kompensacją Kahana, więc błąd zaokrągleń nie rośnie z rozmiarem transformaty.
+ *  @param xdft Pierwsze table.bins() prążków widma sygnału
+ *  @param table Tablica wag dla rozmiaru transformaty, z której pochodzi widmo
+ *  @return Energia sygnału z charakterystyką A (suma kwadratów próbek).
+ */
+double AudioModel::spectrumEnergy(const fftwf_complex *xdft, const WeightingTable &table)
+{
+	const float *weights = table.floatData();
+	const int bins = table.bins();
+
+	float sum = 0.0f;
+	float compensation = 0.0f;
+	for (int i = 0; i < bins; ++i)
+	{
+		const float term = weights[i] * (xdft[i][0] * xdft[i][0] + xdft[i][1] * xdft[i][1]) - compensation;
+		const float t = sum + term;
+		compensation = (t - sum) - term;
+		sum = t;
+	}
+	return sum;
+}
+/**
+ *  @brief Wersja frameEnergy w pojedynczej precyzji: transformata fftwf i wagi WeightingTable::floatData.
+ *  @param x Próbki sygnału (w zakresie [-1,1])
+ *  @param count Liczba próbek
+ *  @param size Rozmiar transformaty, nie mniejszy niż count
+ *  @param response Krzywa korekcji urządzenia; pusty wskaźnik bez korekcji
+ *  @return Energia fragmentu z charakterystyką A.
+ */
+double AudioModel::frameEnergy(const float *x, int count, int size, const QSharedPointer<const FrequencyResponse> &response)
+{
+	FftPlanCache::Lease plan(size, FftPlanCache::RealForwardFloat);
+	float *in = plan.floatIn();
+	std::copy(x, x + count, in);
+	std::fill(in + count, in + size, 0.0f);
+	plan.execute();
+	return spectrumEnergy(plan.floatOut(), *WeightingTable::get(f, size, response));
+}
+/**
+ *  @brief Wersja frameEnergy dla analizy strumieniowej w pojedynczej precyzji.
+ *  @param x Próbki sygnału (w zakresie [-1,1])
+ *  @param count Liczba próbek, nie większa niż transform.size()
+ *  @param transform Plan rodzaju RealForwardFloat z własnymi buforami
+ *  @param table Tablica wag dla rozmiaru transform.size()
+ *  @return Energia fragmentu z charakterystyką A.
+ */
+double AudioModel::frameEnergy(const float *x, int count, const FftPlanCache::Binding &transform, const WeightingTable &table)
+{
+	float *in = transform.floatIn();
+	std::copy(x, x + count, in);
+	std::fill(in + count, in + transform.size(), 0.0f);
+	transform.execute();
+	return spectrumEnergy(transform.floatOut(), table);
+}
+#endif
+/**
+ *  @brief Metoda zamieniająca energię sygnału na równoważny poziom dźwięku w decybelach.
+ *  @param energy Energia sygnału z charakterystyką A
+ *  @param samples Liczba próbek, z których policzono energię
+ *  @param calibrationData Dane kalibracyjne
+ *  @return Głośność w decybelach.
+ */
+double AudioModel::toDecibels(double energy, long long samples, double calibrationData)
+{
+	if (samples <= 0 || energy <= 0.0)
+		return -std::numeric_limits<double>::infinity();
+	return 10 * log10(energy / samples) + calibrationData;
+}
+/**
+ *  @brief Metoda obliczająca głośność w decybelach sygnału rzeczywistego z urządzenia wejścia.
+ *  Dla metody FftEngine korzysta z transformaty r2c i twierdzenia Parsevala, dla IirEngine z filtra charakterystyki A w dziedzinie czasu.
+ *  Korekcję charakterystyki urządzenia stosuje tylko metoda FftEngine: krzywa jest wliczona w wagi charakterystyki A (WeightingTable),
+ *  więc nie dodaje kosztu na prążek. Metoda IirEngine jej nie uwzględnia.
+ *  @param x Orginalny sygnał z urządzenia wejścia (próbki w zakresie [-1,1])
+ *  @param calibrationData Dane kalibracyjne
+ *  @param response Krzywa korekcji charakterystyki częstotliwościowej urządzenia, używana tylko przez FftEngine; pusty wskaźnik bez korekcji
+ *  @return Równoważny poziom dźwięku w decybelach.
+ */
+double AudioModel::computeLevel(const QVector<double> &x, double calibrationData, const QSharedPointer<const FrequencyResponse> &response)
+{
+	int samples = x.length(); // Number of samples (f * seconds)
+	if (currentEngine == IirEngine)
+	{
+		AWeightingFilter filter(f);
+		return toDecibels(filter.energy(x.constData(), samples), samples, calibrationData);
+	}
+    //zwracamy wartość w dB
+	return toDecibels(frameEnergy(x.constData(), samples, samples, response), samples, calibrationData);
 }
 /**
  *  @brief Metoda obliczająca charakterystykę mikrofonu i głośność w decybelach orginalnego sygnału z urządzenia wejścia przy pomocy twierdzenia Parsevala.
@@ -63,23 +222,8 @@ double AudioModel::filterA(double frequency)
  */
 double AudioModel::computeLevel(const QVector<std::complex<double> > &x, double calibrationData)
 {
-	int samples = x.length(); // Number of samples (f * seconds)
-	double total_p = 0.0;
-
-	const long long y = f * (long long) samples;
     //fft
 	auto xdft = fft(x);
-    //w pętli liczymy moduł każdej liczby zespolonej po fft
-	for (int i = 0; i < samples / 2 + 1; ++i)
-	{
-		double p = std::abs(xdft[i]);
-		if (i != 0 && i != samples / 2)
-			p *= filterA(i);
-		p = std::pow(p, 2) / y;
-		if (i != 0 && i != samples / 2)
-			p *= 2;
-		total_p += p;
-	}
     //zwracamy wartość w dB
-	return 10 * log10(total_p) + calibrationData;
+	return toDecibels(weightedEnergy(xdft.constData(), x.length()), x.length(), calibrationData);
 }
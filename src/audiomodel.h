@@ -4,8 +4,23 @@
 #include <QObject>
 #include <QVector>
 #include <complex>
+#include "aweightingfilter.h"
+#include "fftplancache.h"
+#include "frequencyresponse.h"
 
 using std::complex;
+
+class WeightingTable;
+
+/**
+ * @brief Typ próbek w buforach nagrania i analizatora. Przy 16-bitowych próbkach pojedyncza precyzja wystarcza, a zmniejsza o połowę
+ * ilość przesyłanych danych; wybierana jest przy kompilacji opcją CONFIG += single_precision (KK_SINGLE_PRECISION).
+ */
+#ifdef KK_SINGLE_PRECISION
+typedef float Sample;
+#else
+typedef double Sample;
+#endif
 /**
  * @brief Klasa odpowiadająca za obliczanie wyników z pobranych próbek. W trakcie obliczeń korzysta z szybkiej transformaty Fourier'a oraz Twierdzenia Parsevala.
  * @authors Adrianna Łuczak Magdalena Buczyńska Pavel Mukha Adrian Borucki
@@ -13,14 +28,53 @@ using std::complex;
 class AudioModel : public QObject
 {
     Q_OBJECT
+public:
+	/**
+	 * @brief Metoda liczenia głośności.
+	 */
+	enum Engine
+	{
+		FftEngine, /**< Widmo całego sygnału (FFT) ważone tablicą charakterystyki A. */
+		IirEngine /**< Filtr charakterystyki A w dziedzinie czasu (kaskada sekcji bikwadratowych). */
+	};
+
+private:
 	static const int f = 48000;
 
 	static QVector<complex<double> > fft(const QVector<complex<double>> &x);
-	static double filterA(double frequency);
+	static Engine currentEngine;
+
+	static double weightedEnergy(const complex<double> *xdft, int samples);
+	static double spectrumEnergy(const fftw_complex *xdft, const WeightingTable &table);
+#ifdef KK_SINGLE_PRECISION
+	static double spectrumEnergy(const fftwf_complex *xdft, const WeightingTable &table);
+#endif
 	explicit AudioModel(QObject *parent = 0) : QObject(parent) {}
 
+public:
+	static double frameEnergy(const double *x, int count, int size,
+							  const QSharedPointer<const FrequencyResponse> &response = QSharedPointer<const FrequencyResponse>());
+	static double frameEnergy(const double *x, int count, const FftPlanCache::Binding &transform, const WeightingTable &table);
+#ifdef KK_SINGLE_PRECISION
+	static double frameEnergy(const float *x, int count, int size,
+							  const QSharedPointer<const FrequencyResponse> &response = QSharedPointer<const FrequencyResponse>());
+	static double frameEnergy(const float *x, int count, const FftPlanCache::Binding &transform, const WeightingTable &table);
+#endif
+	static double toDecibels(double energy, long long samples, double calibrationData);
+	static void setEngine(Engine engine);
+	static Engine engine();
+	/**
+	 * @brief Zwraca częstotliwość próbkowania, dla której liczone są wyniki.
+	 * @return Częstotliwość próbkowania w Hz.
+	 */
+	static int sampleRate() { return f; }
+
 public slots:
+	static double computeLevel(const QVector<double> &x, double calibrationOffset = 0.0,
+							   const QSharedPointer<const FrequencyResponse> &response = QSharedPointer<const FrequencyResponse>());
 	static double computeLevel(const QVector<std::complex<double> > &x, double calibrationOffset = 0.0);
 };
 
+Q_DECLARE_METATYPE(AudioModel::Engine)
+
 #endif // AUDIOMODEL_H
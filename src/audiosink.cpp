@@ -0,0 +1,413 @@
+#include "audiosink.h"
+#include "pcmconverter.h"
+#include <QDebug>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using std::exception;
+using std::logic_error;
+
+/**
+ * @brief Pojemność bufora cyklicznego w blokach (ok. 2,7 s przy 48 kHz), wielokrotność blockSize, więc pełne bloki są zawsze spójne.
+ * Połowę może zająć bufor wyprzedzenia przekazywany na początku nagrania.
+ */
+static const int ringBlocks = 32;
+
+/**
+ * @brief Konstruktor. Przydziela bufor cykliczny.
+ * @param parent Obiekt nadrzędny.
+ */
+AudioSink::AudioSink(QObject *parent) : QIODevice(parent), ring(ringBlocks * blockSize), targetSamples(0), receivedSamples(0),
+	droppedSamples(0), leadInSamples(0), capturing(false), historySamples(0), frameBytes(0), direct(false)
+{
+}
+/**
+ * @brief Metoda dodająca odbiorcę próbek.
+ * @param consumer Odbiorca; nie jest przejmowany na własność.
+ */
+void AudioSink::addConsumer(SampleConsumer *consumer)
+{
+	if (!consumers.contains(consumer))
+		consumers.append(consumer);
+}
+/**
+ * @brief Metoda usuwająca odbiorcę próbek.
+ * @param consumer Odbiorca.
+ */
+void AudioSink::removeConsumer(SampleConsumer *consumer)
+{
+	consumers.removeOne(consumer);
+}
+/**
+ * @brief Metoda sprawdzająca, czy urządzenie potrafi dekodować dane w podanym formacie.
+ * @param format Format danych.
+ * @return true, jeśli format jest obsługiwany.
+ */
+bool AudioSink::isSupported(const QAudioFormat &format)
+{
+	if (format.codec() != "audio/pcm" || format.channelCount() < 1 || format.sampleRate() <= 0)
+		return false;
+	switch (format.sampleType())
+	{
+	case QAudioFormat::SignedInt:
+		return format.sampleSize() == 16 || format.sampleSize() == 24 || format.sampleSize() == 32;
+	case QAudioFormat::UnSignedInt:
+		return format.sampleSize() == 8;
+	case QAudioFormat::Float:
+		return format.sampleSize() == 32;
+	default:
+		return false;
+	}
+}
+/**
+ * @brief Zwraca największą długość bufora wyprzedzenia, jaką przyjmuje monitor(); cały bufor trafia do bufora cyklicznego
+ * naraz, więc musi zostawić w nim miejsce na próbki napływające w tym czasie.
+ * @return Liczba próbek z częstotliwością analizy.
+ */
+int AudioSink::maxPreRoll()
+{
+	return ringBlocks * blockSize / 2;
+}
+/**
+ * @brief Metoda ustawiająca dekodowanie podanego formatu. Wszystkie bufory pomocnicze i filtr przepróbkowania są tworzone tutaj,
+ * a nie w trakcie nagrania.
+ * @param format Format danych zapisywanych przez QAudioInput.
+ * @throw std::logic_error Jeśli format nie jest obsługiwany.
+ */
+void AudioSink::configure(const QAudioFormat &format)
+{
+	if (!isSupported(format))
+		throw logic_error("Nieobsługiwany format nagrania.");
+	frameBytes = format.channelCount() * format.sampleSize() / 8;
+	partialFrame.clear();
+	partialFrame.reserve(frameBytes);
+	// In continuous mode every sample also goes to the pre-roll history, so decode into the scratch buffer first.
+	direct = history.isEmpty() && format.sampleRate() == AudioModel::sampleRate() && format.channelCount() == 1
+		&& format.sampleSize() == 16 && format.byteOrder() == QAudioFormat::LittleEndian;
+	if (format.sampleRate() != AudioModel::sampleRate())
+	{
+		if (resampler.isNull() || resampler->inputRate() != format.sampleRate())
+		{
+			qDebug() << "Resampling input from" << format.sampleRate() << "Hz to" << AudioModel::sampleRate() << "Hz.";
+			resampler.reset(new Resampler(format.sampleRate(), AudioModel::sampleRate()));
+		}
+		resampler->reset();
+		resampled.resize(resampler->maxOutput(blockSize));
+	}
+	else
+		resampler.reset();
+	decoded.resize(direct ? 0 : blockSize);
+	inputFormat = format;
+}
+/**
+ * @brief Metoda otwierająca urządzenie w trybie ciągłym: próbki są przyjmowane bez przerwy, ale do odbiorców trafiają dopiero
+ * po start(), razem z ostatnimi próbkami sprzed jego wywołania.
+ * @param format Format danych zapisywanych przez QAudioInput.
+ * @param preRollSamples Długość bufora wyprzedzenia w próbkach (z częstotliwością analizy), najwyżej maxPreRoll().
+ * @throw std::logic_error Jeśli format nie jest obsługiwany.
+ */
+void AudioSink::monitor(const QAudioFormat &format, int preRollSamples)
+{
+	if (isOpen())
+		close();
+	history.fill(0.0, qBound(1, preRollSamples, maxPreRoll()));
+	historySamples = 0;
+	try
+	{
+		configure(format);
+	}
+	catch (exception &)
+	{
+		history.clear();
+		throw;
+	}
+	open(QIODevice::WriteOnly);
+}
+/**
+ * @brief Metoda rozpoczynająca nowe nagranie. W trybie ciągłym z tym samym formatem nagranie zaczyna się od zawartości bufora
+ * wyprzedzenia, a urządzenie pozostaje otwarte; w przeciwnym razie urządzenie jest przygotowywane od nowa i otwierane do zapisu.
+ * @param format Format danych zapisywanych przez QAudioInput.
+ * @param samples Liczba próbek (z częstotliwością analizy) od wywołania start(), po której nagranie jest zakończone; próbki bufora
+ * wyprzedzenia (leadIn()) są do niej dodawane.
+ * @throw std::logic_error Jeśli format nie jest obsługiwany.
+ */
+void AudioSink::start(const QAudioFormat &format, long long samples)
+{
+	const bool continuous = isMonitoring() && format == inputFormat;
+	if (!continuous)
+	{
+		if (isOpen())
+			close();
+		history.clear();
+		configure(format);
+	}
+	ring.clear();
+	receivedSamples = 0;
+	droppedSamples = 0;
+	leadInSamples = 0;
+	capturing = true;
+	if (continuous)
+	{
+		// Hand over the pre-roll in chronological order; the ring has room for it by maxPreRoll().
+		// Shortly after monitor() the buffer holds less than the full pre-roll, so the target counts what is actually there.
+		const int length = history.size();
+		const int n = (int) qMin<long long>(historySamples, length);
+		leadInSamples = n;
+		targetSamples = samples + n;
+		const int first = (int) ((historySamples - n) % length);
+		const int tail = qMin(n, length - first);
+		store(history.constData() + first, tail);
+		store(history.constData(), n - tail);
+		// No signal here: the caller first prepares the consumers, and the next write announces these samples too.
+	}
+	else
+	{
+		targetSamples = samples;
+		open(QIODevice::WriteOnly);
+	}
+}
+/**
+ * @brief Metoda kończąca nagranie. W trybie ciągłym urządzenie nadal przyjmuje próbki do bufora wyprzedzenia.
+ */
+void AudioSink::finish()
+{
+	capturing = false;
+	if (!isMonitoring())
+		close();
+}
+/**
+ * @brief Metoda zamykająca urządzenie i kończąca tryb ciągły.
+ */
+void AudioSink::close()
+{
+	capturing = false;
+	history.clear();
+	QIODevice::close();
+}
+/**
+ * @brief Urządzenie służy tylko do zapisu.
+ * @return -1.
+ */
+qint64 AudioSink::readData(char *data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+	return -1;
+}
+/**
+ * @brief Metoda wywoływana przez QAudioInput z kolejną porcją nagrania. Dane ponad zadaną liczbę próbek są pomijane.
+ * @param data Dane PCM.
+ * @param size Liczba bajtów.
+ * @return Liczba przyjętych bajtów (zawsze size).
+ */
+qint64 AudioSink::writeData(const char *data, qint64 size)
+{
+	const uchar *bytes = reinterpret_cast<const uchar *>(data);
+	qint64 left = size;
+	const long long before = receivedSamples;
+	// A frame may be split between two writes.
+	if (!partialFrame.isEmpty())
+	{
+		const int n = (int) qMin<qint64>(frameBytes - partialFrame.size(), left);
+		partialFrame.append(reinterpret_cast<const char *>(bytes), n);
+		bytes += n;
+		left -= n;
+		if (partialFrame.size() == frameBytes)
+		{
+			storeFrames(reinterpret_cast<const uchar *>(partialFrame.constData()), 1);
+			partialFrame.clear();
+		}
+	}
+	const int frames = (int) (left / frameBytes);
+	storeFrames(bytes, frames);
+	bytes += (qint64) frames * frameBytes;
+	left -= (qint64) frames * frameBytes;
+	if (left > 0)
+		partialFrame.append(reinterpret_cast<const char *>(bytes), (int) left);
+
+	if (capturing && receivedSamples > before)
+	{
+		emit samplesAvailable();
+		if (receivedSamples == targetSamples)
+			emit completed();
+	}
+	return size;
+}
+/**
+ * @brief Metoda zamieniająca ramki nagrania na próbki mono z częstotliwością analizy i zapisująca je do bufora cyklicznego.
+ * @param bytes Ramki w formacie wejściowym.
+ * @param count Liczba ramek.
+ */
+void AudioSink::storeFrames(const uchar *bytes, int count)
+{
+	if (direct)
+	{
+		// PCM16 mono at the analysis rate is converted straight into the ring.
+		count = (int) std::min<long long>(count, targetSamples - receivedSamples);
+		while (count > 0)
+		{
+			int space;
+			Sample *out = ring.acquireWrite(space);
+			if (space == 0)
+			{
+				drop(count);
+				return;
+			}
+			const int n = std::min(space, count);
+			PcmConverter::convert(bytes, out, n);
+			ring.commitWrite(n);
+			receivedSamples += n;
+			bytes += n * sizeof(qint16);
+			count -= n;
+		}
+		return;
+	}
+	// Outside continuous mode nothing is needed once the attempt is complete.
+	while (count > 0 && (!history.isEmpty() || receivedSamples < targetSamples))
+	{
+		const int n = std::min(count, blockSize);
+		decode(bytes, n, decoded.data());
+		if (resampler.isNull())
+			keep(decoded.constData(), n);
+		else
+			keep(resampled.constData(), resampler->process(decoded.constData(), n, resampled.data()));
+		bytes += (qint64) n * frameBytes;
+		count -= n;
+	}
+}
+/**
+ * @brief Metoda dekodująca ramki w formacie wejściowym do próbek mono (średnia kanałów).
+ * @param bytes Ramki w formacie wejściowym.
+ * @param count Liczba ramek.
+ * @param out Bufor na count próbek.
+ */
+void AudioSink::decode(const uchar *bytes, int count, Sample *out) const
+{
+	const int channels = inputFormat.channelCount();
+	if (channels == 1 && inputFormat.sampleSize() == 16 && inputFormat.byteOrder() == QAudioFormat::LittleEndian)
+	{
+		PcmConverter::convert(bytes, out, count);
+		return;
+	}
+	const bool little = inputFormat.byteOrder() == QAudioFormat::LittleEndian;
+	const int step = inputFormat.sampleSize() / 8;
+	for (int i = 0; i < count; ++i)
+	{
+		double sum = 0.0;
+		for (int c = 0; c < channels; ++c, bytes += step)
+		{
+			switch (inputFormat.sampleSize())
+			{
+			case 8:
+				sum += (bytes[0] - 128) / 127.0;
+				break;
+			case 16:
+				sum += (little ? qFromLittleEndian<qint16>(bytes) : qFromBigEndian<qint16>(bytes)) / 32767.0;
+				break;
+			case 24:
+			{
+				// Place the sample in the upper 24 bits of a 32-bit word so that it keeps its sign.
+				const uchar *b = bytes;
+				const quint32 word = little ? (quint32) b[0] << 8 | (quint32) b[1] << 16 | (quint32) b[2] << 24
+					: (quint32) b[2] << 8 | (quint32) b[1] << 16 | (quint32) b[0] << 24;
+				sum += (qint32) word / 2147483392.0;
+				break;
+			}
+			default:
+			{
+				const quint32 bits = little ? qFromLittleEndian<quint32>(bytes) : qFromBigEndian<quint32>(bytes);
+				if (inputFormat.sampleType() == QAudioFormat::Float)
+				{
+					float value;
+					std::memcpy(&value, &bits, sizeof(value));
+					sum += value;
+				}
+				else
+					sum += (qint32) bits / 2147483647.0;
+				break;
+			}
+			}
+		}
+		out[i] = (Sample) (sum / channels);
+	}
+}
+/**
+ * @brief Metoda zapisująca zdekodowane próbki do bufora wyprzedzenia (w trybie ciągłym) i, w trakcie nagrania, do bufora cyklicznego.
+ * @param samples Próbki mono z częstotliwością analizy.
+ * @param count Liczba próbek.
+ */
+void AudioSink::keep(const Sample *samples, int count)
+{
+	if (!history.isEmpty())
+	{
+		const int length = history.size();
+		// Only the newest length samples can survive in the history; they are written in at most two runs.
+		const int skip = qMax(0, count - length);
+		const int n = count - skip;
+		const int first = (int) ((historySamples + skip) % length);
+		const int tail = qMin(n, length - first);
+		Sample *h = history.data();
+		std::copy(samples + skip, samples + skip + tail, h + first);
+		std::copy(samples + skip + tail, samples + count, h);
+		historySamples += count;
+	}
+	if (capturing)
+		store(samples, count);
+}
+/**
+ * @brief Metoda kopiująca próbki do bufora cyklicznego. Próbki ponad zadaną liczbę są pomijane.
+ * @param samples Próbki mono z częstotliwością analizy.
+ * @param count Liczba próbek.
+ */
+void AudioSink::store(const Sample *samples, int count)
+{
+	count = (int) std::min<long long>(count, targetSamples - receivedSamples);
+	while (count > 0)
+	{
+		int space;
+		Sample *out = ring.acquireWrite(space);
+		if (space == 0)
+		{
+			drop(count);
+			return;
+		}
+		const int n = std::min(space, count);
+		std::copy(samples, samples + n, out);
+		ring.commitWrite(n);
+		receivedSamples += n;
+		samples += n;
+		count -= n;
+	}
+}
+/**
+ * @brief Metoda pomijająca próbki, dla których zabrakło miejsca w buforze cyklicznym.
+ * @param count Liczba pomijanych próbek.
+ */
+void AudioSink::drop(int count)
+{
+	// The consumers fell more than the ring behind; keep the timing, lose the samples.
+	if (droppedSamples == 0)
+		qDebug() << "Audio sink overrun, dropping samples.";
+	droppedSamples += count;
+	receivedSamples += count;
+}
+/**
+ * @brief Metoda przekazująca odbiorcom wszystkie pełne bloki z bufora cyklicznego. Odbiorcy czytają bezpośrednio z pamięci bufora.
+ * @param flush Czy przekazać także ostatni, niepełny blok (na końcu nagrania).
+ */
+void AudioSink::deliver(bool flush)
+{
+	for (;;)
+	{
+		int count;
+		const Sample *samples = ring.acquireRead(count);
+		if (count == 0 || (count < blockSize && !flush))
+			break;
+		const int n = std::min(count, blockSize);
+		for (SampleConsumer *consumer : consumers)
+			consumer->consume(samples, n);
+		ring.commitRead(n);
+	}
+}
@@ -0,0 +1,107 @@
+#ifndef AUDIOSINK_H
+#define AUDIOSINK_H
+
+#include <QAudioFormat>
+#include <QIODevice>
+#include <QList>
+#include <QScopedPointer>
+#include <QVector>
+#include "resampler.h"
+#include "ringbuffer.h"
+#include "sampleconsumer.h"
+
+/**
+ * @brief Urządzenie, do którego QAudioInput zapisuje nagranie w formacie wynegocjowanym z urządzeniem wejścia. Próbki są dekodowane
+ * od razu do przydzielonego raz bufora cyklicznego, a następnie przekazywane blokami o stałym rozmiarze wszystkim odbiorcom
+ * (ocena, archiwum, miernik poziomu). Kanały są uśredniane, a nagranie o innej częstotliwości niż AudioModel::sampleRate()
+ * jest przepróbkowywane (Resampler), więc odbiorcy zawsze dostają mono z częstotliwością analizy. Dla PCM 16 bitów, mono,
+ * 48 kHz próbki trafiają do bufora bez żadnej kopii pośredniej. W trakcie nagrania nie ma realokacji. Urządzenie przyjmuje
+ * dokładnie zadaną liczbę próbek (po przepróbkowaniu), a po jej zebraniu wysyła sygnał completed().
+ *
+ * W trybie ciągłym (monitor()) urządzenie wejścia działa także między nagraniami, a urządzenie przechowuje ostatnie próbki
+ * w buforze wyprzedzenia. Nagranie rozpoczęte przez start() zaczyna się wtedy od tych próbek (leadIn()), bez opóźnienia uruchamiania
+ * urządzenia wejścia, a finish() kończy nagranie, nie zatrzymując przechwytywania.
+ */
+class AudioSink : public QIODevice
+{
+	Q_OBJECT
+	RingBuffer<Sample> ring;
+	QList<SampleConsumer *> consumers;
+	long long targetSamples;
+	long long receivedSamples;
+	long long droppedSamples;
+	int leadInSamples;
+	bool capturing;
+	QVector<Sample> history;
+	long long historySamples;
+	QAudioFormat inputFormat;
+	int frameBytes;
+	bool direct;
+	QByteArray partialFrame;
+	QScopedPointer<Resampler> resampler;
+	QVector<Sample> decoded;
+	QVector<Sample> resampled;
+
+	void configure(const QAudioFormat &format);
+	void storeFrames(const uchar *bytes, int count);
+	void decode(const uchar *bytes, int count, Sample *out) const;
+	void keep(const Sample *samples, int count);
+	void store(const Sample *samples, int count);
+	void drop(int count);
+protected:
+	qint64 readData(char *data, qint64 maxSize) override;
+	qint64 writeData(const char *data, qint64 size) override;
+public:
+	/**
+	 * @brief Liczba próbek w bloku przekazywanym odbiorcom (ok. 85 ms przy 48 kHz).
+	 */
+	static const int blockSize = 4096;
+
+	explicit AudioSink(QObject *parent = nullptr);
+	bool isSequential() const override { return true; }
+	static bool isSupported(const QAudioFormat &format);
+	void addConsumer(SampleConsumer *consumer);
+	void removeConsumer(SampleConsumer *consumer);
+	void monitor(const QAudioFormat &format, int preRollSamples);
+	void start(const QAudioFormat &format, long long samples);
+	void finish();
+	static int maxPreRoll();
+	/**
+	 * @brief Sprawdza, czy trwa nagranie (od start() do zebrania próbek i finish() lub close()).
+	 * @return true w trakcie nagrania.
+	 */
+	bool isCapturing() const { return capturing; }
+	/**
+	 * @brief Sprawdza, czy urządzenie działa w trybie ciągłym z buforem wyprzedzenia.
+	 * @return true w trybie ciągłym.
+	 */
+	bool isMonitoring() const { return isOpen() && !history.isEmpty(); }
+	void close() override;
+	void deliver(bool flush = false);
+	/**
+	 * @brief Zwraca liczbę próbek odrzuconych od ostatniego start(), bo odbiorcy nie nadążali z odczytem.
+	 * @return Liczba próbek.
+	 */
+	long long dropped() const { return droppedSamples; }
+	/**
+	 * @brief Zwraca liczbę próbek bufora wyprzedzenia, od których zaczyna się nagranie rozpoczęte ostatnim start().
+	 * @return Liczba próbek sprzed wywołania start(); 0 poza trybem ciągłym.
+	 */
+	int leadIn() const { return leadInSamples; }
+	/**
+	 * @brief Zwraca format danych przyjmowanych od ostatniego start().
+	 * @return Format wejściowy.
+	 */
+	QAudioFormat format() const { return inputFormat; }
+signals:
+	/**
+	 * @brief Sygnał wysyłany po zapisaniu nowych próbek do bufora.
+	 */
+	void samplesAvailable();
+	/**
+	 * @brief Sygnał wysyłany raz, gdy urządzenie przyjęło zadaną liczbę próbek.
+	 */
+	void completed();
+};
+
+#endif // AUDIOSINK_H
@@ -0,0 +1,126 @@
+#define _USE_MATH_DEFINES
+
+#include "aweightingfilter.h"
+#include <cmath>
+#include <complex>
+
+/**
+ * @brief Częstotliwości biegunów charakterystyki A według IEC 61672 (Hz).
+ */
+static const double f1 = 20.598997;
+static const double f2 = 107.65265;
+static const double f3 = 737.86223;
+static const double f4 = 12194.217;
+
+/**
+ * @brief Konstruktor. Projektuje filtr dla podanej częstotliwości próbkowania.
+ * @param sampleRate Częstotliwość próbkowania w Hz.
+ */
+AWeightingFilter::AWeightingFilter(int sampleRate)
+{
+	design(sampleRate);
+}
+/**
+ * @brief Metoda tworząca sekcję bikwadratową z iloczynu dwóch analogowych członów pierwszego rzędu s / (s + w) lub 1 / (s + w),
+ * przekształconych podstawieniem biliniowym s = k (1 - z^-1) / (1 + z^-1).
+ * @param differentiator1 Czy pierwszy człon ma zero w s = 0 (s / (s + w)), czy nie (1 / (s + w)).
+ * @param pole1 Pulsacja bieguna pierwszego członu (rad/s).
+ * @param differentiator2 Czy drugi człon ma zero w s = 0.
+ * @param pole2 Pulsacja bieguna drugiego członu (rad/s).
+ * @param k Stała przekształcenia biliniowego (2 * częstotliwość próbkowania).
+ * @return Sekcja bikwadratowa z wyzerowanym stanem.
+ */
+AWeightingFilter::Biquad AWeightingFilter::bilinear(bool differentiator1, double pole1, bool differentiator2, double pole2, double k)
+{
+	// Numerator and denominator of each first order section, as polynomials in z^-1.
+	const double n1[2] = { differentiator1 ? k : 1.0, differentiator1 ? -k : 1.0 };
+	const double n2[2] = { differentiator2 ? k : 1.0, differentiator2 ? -k : 1.0 };
+	const double d1[2] = { k + pole1, pole1 - k };
+	const double d2[2] = { k + pole2, pole2 - k };
+
+	const double a0 = d1[0] * d2[0];
+	Biquad section;
+	section.b0 = n1[0] * n2[0] / a0;
+	section.b1 = (n1[0] * n2[1] + n1[1] * n2[0]) / a0;
+	section.b2 = n1[1] * n2[1] / a0;
+	section.a1 = (d1[0] * d2[1] + d1[1] * d2[0]) / a0;
+	section.a2 = d1[1] * d2[1] / a0;
+	section.z1 = section.z2 = 0.0;
+	return section;
+}
+/**
+ * @brief Metoda projektująca kaskadę dla podanej częstotliwości próbkowania i normująca jej wzmocnienie do 0 dB przy 1 kHz.
+ * @param sampleRate Częstotliwość próbkowania w Hz.
+ */
+void AWeightingFilter::design(int sampleRate)
+{
+	rate = sampleRate;
+	const double k = 2.0 * sampleRate;
+	// H(s) = s^4 / ((s + w1)^2 (s + w2) (s + w3) (s + w4)^2), split into three biquads.
+	sections[0] = bilinear(true, 2 * M_PI * f1, true, 2 * M_PI * f1, k);
+	sections[1] = bilinear(true, 2 * M_PI * f2, true, 2 * M_PI * f3, k);
+	sections[2] = bilinear(false, 2 * M_PI * f4, false, 2 * M_PI * f4, k);
+	gain = 1.0;
+	gain = 1.0 / response(1000.0);
+}
+/**
+ * @brief Metoda zerująca stan filtra przed przetwarzaniem nowego sygnału.
+ */
+void AWeightingFilter::reset()
+{
+	for (int i = 0; i < sectionCount; ++i)
+		sections[i].z1 = sections[i].z2 = 0.0;
+}
+/**
+ * @brief Metoda obliczająca wzmocnienie filtra dla podanej częstotliwości.
+ * @param frequency Częstotliwość w Hz.
+ * @return Moduł transmitancji (nie w dB).
+ */
+double AWeightingFilter::response(double frequency) const
+{
+	const std::complex<double> z1 = std::polar(1.0, -2 * M_PI * frequency / rate); // z^-1
+	const std::complex<double> z2 = z1 * z1;
+	std::complex<double> h = gain;
+	for (int i = 0; i < sectionCount; ++i)
+	{
+		const Biquad &s = sections[i];
+		h *= (s.b0 + s.b1 * z1 + s.b2 * z2) / (1.0 + s.a1 * z1 + s.a2 * z2);
+	}
+	return std::abs(h);
+}
+/**
+ * @brief Metoda filtrująca próbki i zwracająca energię sygnału z charakterystyką A. Stan filtra jest zachowywany między wywołaniami,
+ * więc sygnał można przetwarzać kolejnymi blokami.
+ * @param samples Próbki sygnału.
+ * @param count Liczba próbek.
+ * @return Suma kwadratów przefiltrowanych próbek.
+ */
+double AWeightingFilter::energy(const double *samples, int count)
+{
+	double sum = 0.0;
+	for (int i = 0; i < count; ++i)
+	{
+		double y = process(samples[i]);
+		sum += y * y;
+	}
+	return sum;
+}
+
+/**
+ * @brief Konstruktor.
+ * @param timeConstant Stała czasowa w sekundach.
+ * @param sampleRate Częstotliwość próbkowania w Hz.
+ */
+TimeWeighting::TimeWeighting(double timeConstant, int sampleRate) : value(0.0)
+{
+	setTimeConstant(timeConstant, sampleRate);
+}
+/**
+ * @brief Metoda ustawiająca stałą czasową uśredniania.
+ * @param timeConstant Stała czasowa w sekundach.
+ * @param sampleRate Częstotliwość próbkowania w Hz.
+ */
+void TimeWeighting::setTimeConstant(double timeConstant, int sampleRate)
+{
+	alpha = std::exp(-1.0 / (timeConstant * sampleRate));
+}
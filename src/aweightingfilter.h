@@ -0,0 +1,94 @@
+#ifndef AWEIGHTINGFILTER_H
+#define AWEIGHTINGFILTER_H
+
+/**
+ * @brief Filtr charakterystyki A w dziedzinie czasu: kaskada trzech sekcji bikwadratowych otrzymana z transmitancji analogowej
+ * (IEC 61672) przekształceniem biliniowym dla rzeczywistej częstotliwości próbkowania urządzenia. Przetwarza próbki w czasie O(n)
+ * bez dużych buforów transformaty, więc pozwala też liczyć poziomy z uśrednianiem wykładniczym (Fast/Slow).
+ */
+class AWeightingFilter
+{
+	/**
+	 * @brief Sekcja bikwadratowa w postaci transponowanej drugiej postaci bezpośredniej.
+	 */
+	struct Biquad
+	{
+		double b0, b1, b2, a1, a2;
+		double z1, z2;
+
+		double process(double x)
+		{
+			double y = b0 * x + z1;
+			z1 = b1 * x - a1 * y + z2;
+			z2 = b2 * x - a2 * y;
+			return y;
+		}
+	};
+
+	static const int sectionCount = 3;
+	Biquad sections[sectionCount];
+	double gain;
+	int rate;
+
+	static Biquad bilinear(bool differentiator1, double pole1, bool differentiator2, double pole2, double k);
+public:
+	explicit AWeightingFilter(int sampleRate = 48000);
+	void design(int sampleRate);
+	void reset();
+	double response(double frequency) const;
+	double energy(const double *samples, int count);
+	/**
+	 * @brief Zwraca częstotliwość próbkowania, dla której zaprojektowano filtr.
+	 * @return Częstotliwość próbkowania w Hz.
+	 */
+	int sampleRate() const { return rate; }
+	/**
+	 * @brief Filtruje jedną próbkę.
+	 * @param x Próbka wejściowa.
+	 * @return Próbka sygnału z charakterystyką A.
+	 */
+	double process(double x)
+	{
+		double y = x * gain;
+		for (int i = 0; i < sectionCount; ++i)
+			y = sections[i].process(y);
+		return y;
+	}
+};
+
+/**
+ * @brief Wykładnicze uśrednianie kwadratu sygnału ze stałą czasową Fast (125 ms) lub Slow (1 s), jak w mierniku poziomu dźwięku.
+ */
+class TimeWeighting
+{
+	double alpha;
+	double value;
+public:
+	/**
+	 * @brief Stała czasowa Fast w sekundach.
+	 */
+	static constexpr double fast = 0.125;
+	/**
+	 * @brief Stała czasowa Slow w sekundach.
+	 */
+	static constexpr double slow = 1.0;
+
+	TimeWeighting(double timeConstant = fast, int sampleRate = 48000);
+	void setTimeConstant(double timeConstant, int sampleRate);
+	/**
+	 * @brief Zeruje stan uśredniania.
+	 */
+	void reset() { value = 0.0; }
+	/**
+	 * @brief Dodaje kwadrat kolejnej próbki.
+	 * @param squared Kwadrat próbki sygnału z charakterystyką A.
+	 * @return Bieżąca wartość średniokwadratowa.
+	 */
+	double process(double squared)
+	{
+		value = squared + alpha * (value - squared);
+		return value;
+	}
+};
+
+#endif // AWEIGHTINGFILTER_H
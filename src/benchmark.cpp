@@ -0,0 +1,277 @@
+#define _USE_MATH_DEFINES
+
+#include "benchmark.h"
+#include "compressedaudiofile.h"
+#include "audiomodel.h"
+#include "audiosink.h"
+#include "levelanalyzer.h"
+#include "losslesscodec.h"
+#include "pcmconverter.h"
+#include "resampler.h"
+#include "tonedetector.h"
+#include "wavreader.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <algorithm>
+#include <exception>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Liczba powtórzeń każdego pomiaru czasu.
+ */
+static const int passes = 20;
+
+/**
+ * @brief Metoda uruchamiająca wszystkie pomiary dla podanego pliku.
+ * @param fileName Nazwa pliku WAV (PCM, 16 bitów, mono, 48 kHz).
+ * @return Kod wyjścia programu.
+ */
+int Benchmark::run(const QString &fileName)
+{
+	Benchmark benchmark;
+	if (!benchmark.load(fileName))
+	{
+		qDebug() << "Could not read" << fileName;
+		return 1;
+	}
+	qDebug() << "Benchmark:" << fileName << benchmark.samples() << "samples";
+	benchmark.compareConversion();
+#ifdef KK_SINGLE_PRECISION
+	benchmark.comparePrecision();
+#endif
+	benchmark.measureArchive();
+	benchmark.measureResampler();
+	benchmark.measureToneDetector();
+	return 0;
+}
+/**
+ * @brief Metoda wczytująca próbki z pliku WAV.
+ * @param fileName Nazwa pliku (PCM, 16 bitów, mono).
+ * @return Czy wczytano jakiekolwiek próbki.
+ */
+bool Benchmark::load(const QString &fileName)
+{
+	WavReader reader(fileName);
+	try
+	{
+		reader.open();
+	}
+	catch (std::exception &e)
+	{
+		qDebug() << e.what();
+		return false;
+	}
+	if (reader.isCompressed() || reader.encoding() != WavReader::Pcm16 || reader.channelCount() != 1)
+		return false;
+	pcm = QByteArray(reinterpret_cast<const char *>(reader.data()), reader.frames() * reader.bytesPerFrame());
+	return samples() > 0;
+}
+/**
+ * @brief Pomiar zamiany PCM na próbki: dawne czytanie po jednej próbce przez QDataStream do niezarezerwowanego QVector
+ * i PcmConverter we wszystkich wariantach obsługiwanych przez procesor, do przygotowanego bufora. Czas podawany jest na całe nagranie.
+ */
+void Benchmark::compareConversion() const
+{
+	const int count = samples();
+	QElapsedTimer timer;
+	timer.start();
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		QDataStream stream(pcm);
+		stream.setByteOrder(QDataStream::LittleEndian);
+		QVector<Sample> x;
+		while (!stream.atEnd())
+		{
+			short i;
+			stream >> i;
+			x.push_back((Sample) i / (Sample) std::numeric_limits<short>::max());
+		}
+	}
+	qDebug() << "PCM QDataStream:" << timer.nsecsElapsed() / 1000.0 / passes << "us";
+
+	QVector<Sample> x(count);
+	const uchar *bytes = reinterpret_cast<const uchar *>(pcm.constData());
+	for (int k = PcmConverter::Scalar; k <= PcmConverter::Avx2; ++k)
+	{
+		const PcmConverter::Kernel kernel = (PcmConverter::Kernel) k;
+		if (!PcmConverter::isSupported(kernel))
+			continue;
+		timer.restart();
+		for (int pass = 0; pass < passes; ++pass)
+			PcmConverter::convert(bytes, x.data(), count, kernel);
+		qDebug() << "PCM" << PcmConverter::name(kernel) << ":" << timer.nsecsElapsed() / 1000.0 / passes << "us";
+	}
+}
+#ifdef KK_SINGLE_PRECISION
+/**
+ * @brief Pomiar ścieżki FFT w pojedynczej i podwójnej precyzji: przepustowość AudioModel::frameEnergy dla ramek
+ * LevelAnalyzer::frameSize oraz największa różnica poziomu pojedynczej ramki i całego nagrania.
+ */
+void Benchmark::comparePrecision() const
+{
+	const int count = this->samples();
+	const int size = LevelAnalyzer::frameSize;
+	QVector<double> samples(count);
+	QVector<float> floatSamples(count);
+	PcmConverter::convert(reinterpret_cast<const uchar *>(pcm.constData()), samples.data(), count);
+	PcmConverter::convert(reinterpret_cast<const uchar *>(pcm.constData()), floatSamples.data(), count);
+	// Create (and measure) both plans before timing.
+	AudioModel::frameEnergy(samples.constData(), 0, size);
+	AudioModel::frameEnergy(floatSamples.constData(), 0, size);
+
+	double total = 0.0, floatTotal = 0.0, maxDeviation = 0.0;
+	for (int done = 0; done < count; done += size)
+	{
+		const int n = std::min(size, count - done);
+		const double e = AudioModel::frameEnergy(samples.constData() + done, n, size);
+		const double ef = AudioModel::frameEnergy(floatSamples.constData() + done, n, size);
+		total += e;
+		floatTotal += ef;
+		if (e > 0.0 && ef > 0.0)
+			maxDeviation = std::max(maxDeviation, std::fabs(10 * log10(ef / e)));
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int pass = 0; pass < passes; ++pass)
+		for (int done = 0; done < count; done += size)
+			AudioModel::frameEnergy(samples.constData() + done, std::min(size, count - done), size);
+	const qint64 doubleTime = std::max<qint64>(timer.nsecsElapsed(), 1);
+	timer.restart();
+	for (int pass = 0; pass < passes; ++pass)
+		for (int done = 0; done < count; done += size)
+			AudioModel::frameEnergy(floatSamples.constData() + done, std::min(size, count - done), size);
+	const qint64 floatTime = std::max<qint64>(timer.nsecsElapsed(), 1);
+
+	const double megaSamples = (double) count * passes / 1e6;
+	qDebug() << "FFT double:" << megaSamples / (doubleTime * 1e-9) << "Msamples/s";
+	qDebug() << "FFT float: " << megaSamples / (floatTime * 1e-9) << "Msamples/s";
+	qDebug() << "Max frame deviation:" << maxDeviation << "dB";
+	qDebug() << "Leq deviation:" << std::fabs(AudioModel::toDecibels(floatTotal, count, 0.0) - AudioModel::toDecibels(total, count, 0.0)) << "dB";
+}
+#endif
+/**
+ * @brief Pomiar archiwum skompresowanego (LosslessCodec, bloki CompressedAudioFile::blockSize): stopień kompresji względem WAV
+ * oraz szybkość dekodowania jako wielokrotność czasu rzeczywistego.
+ */
+void Benchmark::measureArchive() const
+{
+	const int count = samples();
+	const int size = CompressedAudioFile::blockSize;
+	QVector<qint16> x(count);
+	for (int i = 0; i < count; ++i)
+		x[i] = qFromLittleEndian<qint16>(pcm.constData() + i * sizeof(qint16));
+
+	QByteArray encoded;
+	QVector<int> offsets;
+	QElapsedTimer timer;
+	timer.start();
+	for (int done = 0; done < count; done += size)
+	{
+		offsets.append(encoded.size());
+		LosslessCodec::encodeBlock(x.constData() + done, std::min(size, count - done), encoded);
+	}
+	offsets.append(encoded.size());
+	const qint64 encodeTime = std::max<qint64>(timer.nsecsElapsed(), 1);
+
+	QVector<qint16> y(count);
+	bool lossless = true;
+	timer.restart();
+	for (int pass = 0; pass < passes; ++pass)
+		for (int block = 0, done = 0; done < count; ++block, done += size)
+			lossless &= LosslessCodec::decodeBlock(reinterpret_cast<const uchar *>(encoded.constData()) + offsets[block],
+												   offsets[block + 1] - offsets[block], y.data() + done, std::min(size, count - done));
+	const qint64 decodeTime = std::max<qint64>(timer.nsecsElapsed(), 1);
+	lossless &= x == y;
+
+	const double seconds = (double) count / AudioModel::sampleRate();
+	qDebug() << "Archive ratio (WAV / kka):" << (double) (pcm.size() + 44) / (encoded.size() + CompressedAudioFile::headerSize + 4 + 8 * offsets.size());
+	qDebug() << "Archive encode:" << seconds / (encodeTime * 1e-9) << "x real time";
+	qDebug() << "Archive decode:" << seconds * passes / (decodeTime * 1e-9) << "x real time," << (lossless ? "lossless" : "MISMATCH");
+}
+/**
+ * @brief Pomiar przepróbkowania 44,1 -> 48 kHz (Resampler): przepustowość dla próbek nagrania traktowanych jak próbki 44,1 kHz,
+ * podawanych blokami AudioSink::blockSize, oraz stosunek sygnału do błędu dla sinusa 1 kHz względem sinusa idealnego.
+ */
+void Benchmark::measureResampler() const
+{
+	const int inputRate = 44100;
+	const int count = samples();
+	const int size = AudioSink::blockSize;
+	QVector<Sample> x(count);
+	PcmConverter::convert(reinterpret_cast<const uchar *>(pcm.constData()), x.data(), count);
+	Resampler resampler(inputRate, AudioModel::sampleRate());
+	QVector<Sample> y(resampler.maxOutput(size));
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		resampler.reset();
+		for (int done = 0; done < count; done += size)
+			resampler.process(x.constData() + done, std::min(size, count - done), y.data());
+	}
+	const qint64 time = std::max<qint64>(timer.nsecsElapsed(), 1);
+
+	// One second of a 1 kHz sine; skip the filter's start-up transient and the unflushed tail.
+	QVector<Sample> sine(inputRate);
+	for (int i = 0; i < inputRate; ++i)
+		sine[i] = (Sample) (0.5 * std::sin(2.0 * M_PI * 1000.0 * i / inputRate));
+	resampler.reset();
+	QVector<Sample> out(resampler.maxOutput(sine.size()));
+	const int produced = resampler.process(sine.constData(), sine.size(), out.data());
+	const double delay = resampler.delay() / inputRate;
+	double signal = 0.0, error = 0.0;
+	for (int j = AudioModel::sampleRate() / 10; j < produced - AudioModel::sampleRate() / 100; ++j)
+	{
+		const double expected = 0.5 * std::sin(2.0 * M_PI * 1000.0 * ((double) j / AudioModel::sampleRate() - delay));
+		signal += expected * expected;
+		error += (out[j] - expected) * (out[j] - expected);
+	}
+
+	const double seconds = (double) count / inputRate;
+	qDebug() << "Resampler 44.1 -> 48 kHz:" << (double) count * passes / 1e6 / (time * 1e-9) << "Msamples/s,"
+			 << seconds * passes / (time * 1e-9) << "x real time";
+	qDebug() << "Resampler 1 kHz SNR:" << 10 * log10(signal / std::max(error, 1e-30)) << "dB";
+}
+/**
+ * @brief Pomiar detektora tonu kalibracyjnego (ToneDetector) w porównaniu z analizą pełnego widma (LevelAnalyzer z FFT)
+ * oraz wynik sprawdzenia tonu w nagraniu.
+ */
+void Benchmark::measureToneDetector() const
+{
+	const int count = samples();
+	const int size = AudioSink::blockSize;
+	QVector<Sample> x(count);
+	PcmConverter::convert(reinterpret_cast<const uchar *>(pcm.constData()), x.data(), count);
+	ToneDetector detector;
+	LevelAnalyzer analyzer;
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		detector.reset();
+		for (int done = 0; done < count; done += size)
+			detector.consume(x.constData() + done, std::min(size, count - done));
+	}
+	const qint64 toneTime = std::max<qint64>(timer.nsecsElapsed(), 1);
+	const ToneCheck tone = detector.result();
+	timer.restart();
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		analyzer.reset();
+		for (int done = 0; done < count; done += size)
+			analyzer.process(x.constData() + done, std::min(size, count - done));
+		analyzer.finish();
+	}
+	const qint64 analyzerTime = std::max<qint64>(timer.nsecsElapsed(), 1);
+
+	const double megaSamples = (double) count * passes / 1e6;
+	qDebug() << "Tone detector:" << megaSamples / (toneTime * 1e-9) << "Msamples/s, level analyzer:"
+			 << megaSamples / (analyzerTime * 1e-9) << "Msamples/s";
+	qDebug() << "Tone:" << tone.frequency << "Hz, purity" << tone.purity << ", level" << tone.level << "dB, present" << tone.present;
+}
@@ -0,0 +1,28 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Klasa mierząca wydajność ścieżek obliczeniowych programu na nagraniu z pliku. Uruchamiana poleceniem
+ * <tt>kk --benchmark [plik.wav]</tt> (domyślnie kalibracja.wav), wyniki wypisuje przez qDebug.
+ */
+class Benchmark
+{
+	QByteArray pcm;
+
+	bool load(const QString &fileName);
+	int samples() const { return pcm.size() / (int) sizeof(qint16); }
+#ifdef KK_SINGLE_PRECISION
+	void comparePrecision() const;
+#endif
+	void compareConversion() const;
+	void measureArchive() const;
+	void measureResampler() const;
+	void measureToneDetector() const;
+public:
+	static int run(const QString &fileName);
+};
+
+#endif // BENCHMARK_H
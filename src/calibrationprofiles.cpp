@@ -0,0 +1,110 @@
+#include "calibrationprofiles.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QSettings>
+#include <QStandardPaths>
+
+/**
+ * @brief Zwraca jedyną instancję profili, wczytując je przy pierwszym użyciu.
+ * @return Profile kalibracji współdzielone przez wszystkie stanowiska.
+ */
+CalibrationProfiles &CalibrationProfiles::instance()
+{
+	static CalibrationProfiles profiles;
+	return profiles;
+}
+/**
+ * @brief Konstruktor. Wczytuje profile z pliku w katalogu danych programu.
+ */
+CalibrationProfiles::CalibrationProfiles()
+{
+	QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+	if (dir.isEmpty())
+		dir = QCoreApplication::applicationDirPath();
+	QDir().mkpath(dir);
+	fileName = QDir(dir).filePath("kalibracja.ini");
+	load();
+}
+/**
+ * @brief Metoda szukająca profilu urządzenia.
+ * @param deviceName Nazwa urządzenia wejścia.
+ * @param format Format próbek, w jakim urządzenie nagrywa.
+ * @param profile Znaleziony profil.
+ * @return true, jeśli urządzenie było już kalibrowane w tym formacie.
+ */
+bool CalibrationProfiles::find(const QString &deviceName, const QAudioFormat &format, Profile &profile) const
+{
+	auto it = profiles.constFind(key(deviceName, format));
+	if (it == profiles.constEnd())
+		return false;
+	profile = it.value();
+	return true;
+}
+/**
+ * @brief Metoda zapamiętująca profil urządzenia i zapisująca wszystkie profile na dysku.
+ * @param deviceName Nazwa urządzenia wejścia.
+ * @param format Format próbek, w jakim urządzenie nagrywa.
+ * @param profile Nowy profil.
+ */
+void CalibrationProfiles::store(const QString &deviceName, const QAudioFormat &format, const Profile &profile)
+{
+	profiles.insert(key(deviceName, format), profile);
+	save();
+}
+/**
+ * @brief Metoda wczytująca profile z pliku.
+ */
+void CalibrationProfiles::load()
+{
+	QSettings settings(fileName, QSettings::IniFormat);
+	const int count = settings.beginReadArray("profiles");
+	for (int i = 0; i < count; ++i)
+	{
+		settings.setArrayIndex(i);
+		Profile profile;
+		profile.calibrationData = settings.value("calibrationData").toDouble();
+		profile.measured = settings.value("measured").toDateTime();
+		profile.stability = settings.value("stability", -1.0).toDouble();
+		profile.response = FrequencyResponse::fromString(settings.value("response").toString());
+		profiles.insert(settings.value("key").toString(), profile);
+	}
+	settings.endArray();
+	qDebug() << "Loaded" << profiles.size() << "calibration profiles from" << fileName;
+}
+/**
+ * @brief Metoda zapisująca wszystkie profile do pliku. Nazwy urządzeń mogą zawierać ukośniki, więc są wartościami, a nie kluczami ustawień.
+ */
+void CalibrationProfiles::save() const
+{
+	QSettings settings(fileName, QSettings::IniFormat);
+	settings.remove("profiles");
+	settings.beginWriteArray("profiles", profiles.size());
+	int i = 0;
+	for (auto it = profiles.constBegin(); it != profiles.constEnd(); ++it, ++i)
+	{
+		settings.setArrayIndex(i);
+		settings.setValue("key", it.key());
+		settings.setValue("calibrationData", it.value().calibrationData);
+		settings.setValue("measured", it.value().measured);
+		settings.setValue("stability", it.value().stability);
+		if (!it.value().response.isNull())
+			settings.setValue("response", it.value().response->toString());
+	}
+	settings.endArray();
+	settings.sync();
+	if (settings.status() != QSettings::NoError)
+		qDebug() << "Could not save calibration profiles to" << fileName;
+}
+/**
+ * @brief Zwraca klucz profilu. Ten sam mikrofon w innym formacie (np. z inną częstotliwością próbkowania) może mieć inne wzmocnienie,
+ * więc format jest częścią klucza.
+ * @param deviceName Nazwa urządzenia wejścia.
+ * @param format Format próbek.
+ * @return Klucz profilu.
+ */
+QString CalibrationProfiles::key(const QString &deviceName, const QAudioFormat &format)
+{
+	return QString("%1|%2 Hz|%3 ch|%4 bit|%5").arg(deviceName).arg(format.sampleRate()).arg(format.channelCount())
+		.arg(format.sampleSize()).arg(format.sampleType());
+}
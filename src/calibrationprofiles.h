@@ -0,0 +1,48 @@
+#ifndef CALIBRATIONPROFILES_H
+#define CALIBRATIONPROFILES_H
+
+#include <QAudioFormat>
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include "frequencyresponse.h"
+
+/**
+ * @brief Zapisane na dysku profile kalibracji, po jednym dla każdego urządzenia wejścia i formatu próbek. Plik wczytywany jest raz,
+ * przy pierwszym użyciu, a każda nowa kalibracja zapisuje go od razu, więc po zmianie urządzenia lub ponownym uruchomieniu
+ * programu dane kalibracyjne są dostępne bez ponownego nagrywania sygnału kalibracyjnego.
+ */
+class CalibrationProfiles
+{
+public:
+	/**
+	 * @brief Profil kalibracji jednego urządzenia.
+	 */
+	struct Profile
+	{
+		double calibrationData; /**< Poprawka w decybelach dodawana do wyników. */
+		QDateTime measured; /**< Czas pomiaru sygnału kalibracyjnego. */
+		double stability; /**< Rozrzut poziomu sygnału kalibracyjnego w decybelach; ujemny, jeśli nie był mierzony. */
+		QSharedPointer<const FrequencyResponse> response; /**< Krzywa korekcji charakterystyki; pusty wskaźnik, jeśli nie była mierzona. */
+
+		Profile() : calibrationData(0.0), stability(-1.0) {}
+	};
+
+	static CalibrationProfiles &instance();
+	bool find(const QString &deviceName, const QAudioFormat &format, Profile &profile) const;
+	void store(const QString &deviceName, const QAudioFormat &format, const Profile &profile);
+
+private:
+	QHash<QString, Profile> profiles;
+	QString fileName;
+
+	CalibrationProfiles();
+	CalibrationProfiles(const CalibrationProfiles &) = delete;
+	CalibrationProfiles &operator=(const CalibrationProfiles &) = delete;
+
+	void load();
+	void save() const;
+	static QString key(const QString &deviceName, const QAudioFormat &format);
+};
+
+#endif // CALIBRATIONPROFILES_H
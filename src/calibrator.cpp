@@ -1,51 +1,294 @@
 #include "calibrator.h"
-#include "audiomodel.h"
+#include "calibrationprofiles.h"
+#include <cmath>
+#include <stdexcept>
+
+using std::logic_error;
 /**
- *  @param  calibrationData Dane kalibracyjne, przechowujące głośność w decybelach. Początkowo zaincjalizowane na wartość 0.0.
- */
-double Calibrator::calibrationData = 0.0;
-/**
- *  @brief Konstruktor. Wywołuje pomiar z urządzenia wejścia.
+ *  @brief Konstruktor. Wczytuje profil kalibracji bieżącego urządzenia rejestratora, śledzi zmiany urządzenia i sprawdza ton
+ *  kalibracyjny w każdym nagraniu rejestratora.
  * @author Pavel Mukha Kamil Wasilewski
  */
-Calibrator::Calibrator(Recorder *recorder, QObject *parent) : QObject(parent)
+Calibrator::Calibrator(Recorder *recorder, QObject *parent) : QObject(parent), calibrationData(0.0), tolerance(0.0), maxDuration(5000),
+	adaptiveRun(false), fixedDuration(0), measurementTime(0), stability(-1.0), stableLevel(0.0), stable(false),
+	calibrating(false), liveRun(false), accepted(false), kind(LevelCalibration), responseRun(false)
 {
 	this->recorder = recorder;
+	connect(recorder, SIGNAL(deviceChanged()), this, SLOT(LoadProfile()));
+	connect(recorder, SIGNAL(toneMeasured(const ToneCheck &)), this, SLOT(OnToneMeasured(const ToneCheck &)));
+	LoadProfile();
+}
+/**
+ *  @brief Metoda wczytująca profil kalibracji urządzenia wejścia rejestratora i przekazująca rejestratorowi jego krzywą korekcji.
+ *  Jeśli urządzenie nie było kalibrowane w tym formacie, dane kalibracyjne są zerowane, aby nie stosować poprawki innego mikrofonu.
+ */
+void Calibrator::LoadProfile()
+{
+	CalibrationProfiles::Profile profile;
+	if (CalibrationProfiles::instance().find(recorder->DeviceName(), recorder->Format(), profile))
+	{
+		calibrationData = profile.calibrationData;
+		calibrationTime = profile.measured;
+		stability = profile.stability;
+		response = profile.response;
+	}
+	else
+	{
+		calibrationData = 0.0;
+		calibrationTime = QDateTime();
+		stability = -1.0;
+		response.reset();
+	}
+	recorder->SetResponse(response);
+	qDebug() << "Calibration of" << recorder->DeviceName() << ":" << calibrationData << calibrationTime;
+}
+/**
+ *  @brief Metoda włączająca lub wyłączająca tryb adaptacyjny kalibracji.
+ *  @param tolerance Dopuszczalne odchylenie poziomu sygnału kalibracyjnego w decybelach; 0 wyłącza tryb adaptacyjny.
+ *  @param maxDuration Maksymalny czas nagrywania sygnału kalibracyjnego w milisekundach.
+ *  @throw std::logic_error Jeśli tolerancja jest ujemna albo czas nie jest dłuższy niż czas ustalania się poziomu.
+ */
+void Calibrator::SetAdaptive(double tolerance, int maxDuration)
+{
+	if (tolerance < 0.0)
+		throw logic_error("Tolerancja kalibracji nie może być ujemna.");
+	if (maxDuration <= holdTime)
+		throw logic_error("Maksymalny czas kalibracji musi być dłuższy niż czas ustalania się poziomu.");
+	this->tolerance = tolerance;
+	this->maxDuration = maxDuration;
 }
 /**
  *  @brief Metoda wywołująca nagrywanie z urządzenia wejścia a następnie wywołuje metodę recordingStopped. Działa na sygnałach.
+ *  W trybie adaptacyjnym nagranie trwa do ustalenia się poziomu, najdłużej MaxDuration().
+ *  @throw std::logic_error Jeśli urządzenie wejścia dostarcza próbki w nieobsługiwanym formacie.
  * @authors Pavel Mukha Kamil Wasilewski
  */
 void Calibrator::Calibrate()
 {
     //łączy się z recorderem i uruchamia nagrywanie
-	connect(recorder, SIGNAL(recordingStopped(const QVector<std::complex<double> > &)), this, SLOT(OnRecordingStopped(const QVector<std::complex<double> > &)));
-    recorder->Start();
+	connect(recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(OnRecordingStopped(const LevelMetrics &)));
+	connect(recorder, SIGNAL(stabilityMeasured(double, double, bool)), this, SLOT(OnStabilityMeasured(double, double, bool)));
+	stability = -1.0;
+	stable = false;
+	tone = ToneCheck();
+	calibrating = true;
+	kind = LevelCalibration;
+	//nagrywanie bez tonu kalibracyjnego kończy się po pierwszych blokach, bo i tak nie zostanie przyjęte
+	liveRun = true;
+	recorder->SetToneRequired(true);
+	//w trybie adaptacyjnym czas nagrania jest tylko górnym ograniczeniem
+	adaptiveRun = tolerance > 0.0;
+	if (adaptiveRun)
+	{
+		fixedDuration = recorder->Duration();
+		recorder->SetDuration(maxDuration);
+		recorder->SetStabilityTarget(tolerance, holdTime);
+	}
+	elapsed.start();
+	try
+	{
+		recorder->Start(ArchiveWriter::calibrationFileName());
+	}
+	catch (exception &)
+	{
+		endRun();
+		disconnect(recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(OnRecordingStopped(const LevelMetrics &)));
+		disconnect(recorder, SIGNAL(stabilityMeasured(double, double, bool)), this, SLOT(OnStabilityMeasured(double, double, bool)));
+		throw;
+	}
+}
+/**
+ *  @brief Metoda kończąca kalibrację: wyłącza wymaganie tonu i wcześniejsze kończenie nagrań oraz przywraca zwykły czas nagrania.
+ */
+void Calibrator::endRun()
+{
+	calibrating = false;
+	if (liveRun)
+	{
+		liveRun = false;
+		recorder->SetToneRequired(false);
+	}
+	if (adaptiveRun)
+	{
+		adaptiveRun = false;
+		recorder->SetStabilityTarget(0.0, holdTime);
+		recorder->SetDuration(fixedDuration);
+	}
+	if (responseRun)
+	{
+		responseRun = false;
+		recorder->SetResponseMeasurement(false);
+	}
+}
+/**
+ *  @brief Metoda zapisująca bieżące dane kalibracyjne i krzywą korekcji w profilu urządzenia, aby nie kalibrować go ponownie
+ *  po zmianie urządzenia lub ponownym uruchomieniu.
+ */
+void Calibrator::storeProfile() const
+{
+	CalibrationProfiles::Profile profile;
+	profile.calibrationData = calibrationData;
+	profile.measured = calibrationTime;
+	profile.stability = stability;
+	profile.response = response;
+	CalibrationProfiles::instance().store(recorder->DeviceName(), recorder->Format(), profile);
 }
 /**
  *  @brief Metoda wywołująca kalibrację poprzez pobranie próbki z pliku.
  *  @param  fileName Ścieżka do pliku
+ *  @throw std::logic_error Jeśli pliku nie można wczytać.
  * @authors Kamil Wasilewski
  */
 void Calibrator::CalibrateFromFile(const QString &fileName)
 {
-    connect(recorder, SIGNAL(recordingStopped(const QVector<std::complex<double> > &)), this, SLOT(OnRecordingStopped(const QVector<std::complex<double> > &)));
+    connect(recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(OnRecordingStopped(const LevelMetrics &)));
+	stability = -1.0;
+	stable = false;
+	tone = ToneCheck();
+	calibrating = true;
+	kind = LevelCalibration;
+	elapsed.invalidate();
     //wczytuje Audio z pliku
-    recorder->LoadAudioDataFromFile(fileName);
+	try
+	{
+		recorder->LoadAudioDataFromFile(fileName);
+	}
+	catch (exception &)
+	{
+		calibrating = false;
+		disconnect(recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(OnRecordingStopped(const LevelMetrics &)));
+		throw;
+	}
+}
+/**
+ *  @brief Slot zapamiętujący stabilność sygnału kalibracyjnego, wysyłaną przez Recorder tuż przed zakończeniem nagrania.
+ *  @param level Poziom okna, w którym sygnał się ustalił (albo ostatniego okna) w decybelach.
+ *  @param deviation Największe odchylenie poziomu w tym oknie w decybelach.
+ *  @param stable true, jeśli poziom ustalił się w tolerancji.
+ */
+void Calibrator::OnStabilityMeasured(double level, double deviation, bool stable)
+{
+	stableLevel = level;
+	stability = deviation;
+	this->stable = stable;
 }
 /**
- *  @brief Metoda kończąca pobieranie danych kalibracyjnych i odsyłająca je do AudioModel w celu wyliczenia wartości w decybelach.
+ *  @brief Slot sprawdzający ton kalibracyjny nagrania. W trakcie kalibracji zapamiętuje wynik, a w zwykłym nagraniu, jeśli zawiera ton
+ *  kalibracyjny, porównuje jego poziom po kalibracji z 94 dB, czyli sprawdza w tle, czy dane kalibracyjne są nadal aktualne.
+ *  @param tone Częstotliwość, czystość i poziom tonu (bez danych kalibracyjnych).
+ */
+void Calibrator::OnToneMeasured(const ToneCheck &tone)
+{
+	if (calibrating)
+	{
+		this->tone = tone;
+		return;
+	}
+	if (!tone.present || !calibrationTime.isValid())
+		return;
+	const double drift = tone.level + calibrationData - 94.0;
+	qDebug() << "Ton kalibracyjny w nagraniu:" << tone.frequency << "Hz, odchyłka" << drift << "dB";
+	if (std::fabs(drift) > driftTolerance)
+		emit calibrationDrifted(drift);
+}
+/**
+ *  @brief Metoda kończąca pobieranie danych kalibracyjnych i wyliczająca dane kalibracyjne z głośności sygnału kalibracyjnego.
  *
- *  @param  x tablica liczb zespolonych.
+ *  @param  metrics miary głośności sygnału kalibracyjnego w decybelach, policzone przez Recorder. Kalibracja korzysta z Leq, a kalibracja
+ *  adaptacyjna zakończona ustaleniem się poziomu z poziomu okna, w którym się ustalił (bez początkowego stanu nieustalonego).
+ *  Jeśli nie wykryto tonu kalibracyjnego (np. wybrano niewłaściwe urządzenie), dane kalibracyjne pozostają bez zmian.
  * @authors Pavel Mukha Kamil Wasilewski
  */
-void Calibrator::OnRecordingStopped(const QVector<std::complex<double> > &x)
+void Calibrator::OnRecordingStopped(const LevelMetrics &metrics)
 {
     //odłączenie recordera
-    disconnect(recorder, 0, this, 0);
+	disconnect(recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(OnRecordingStopped(const LevelMetrics &)));
+	disconnect(recorder, SIGNAL(stabilityMeasured(double, double, bool)), this, SLOT(OnStabilityMeasured(double, double, bool)));
+	const bool useStableLevel = adaptiveRun && stable;
+	endRun();
+	measurementTime = elapsed.isValid() ? (int) elapsed.elapsed() : 0;
+    //bez tonu kalibracyjnego poprawka byłaby błędna dla wszystkich kolejnych wyników
+	accepted = tone.present;
+	if (!accepted)
+	{
+		qDebug() << "Nie wykryto tonu kalibracyjnego:" << tone.frequency << "Hz, czystość" << tone.purity << ", poziom" << tone.level << "dB";
+		emit calibrationStopped();
+		return;
+	}
     //obliczamy dane kalibracyjne
-    calibrationData = 94.0 - AudioModel::computeLevel(x);
-	qDebug() << "Wartość kalibracji: " << calibrationData;
+	calibrationData = 94.0 - (useStableLevel ? stableLevel : metrics.leq);
+	calibrationTime = QDateTime::currentDateTime();
+	qDebug() << "Wartość kalibracji: " << calibrationData << "stabilność:" << stability << "dB, ustalona:" << stable
+			 << "czas:" << measurementTime << "ms";
+    //zapisujemy profil urządzenia, aby nie kalibrować go ponownie po zmianie urządzenia lub ponownym uruchomieniu
+	storeProfile();
     //konczymy kalibrację
 	emit calibrationStopped();
 }
+/**
+ *  @brief Metoda uruchamiająca kalibrację charakterystyki częstotliwościowej: nagrywa sygnał o jednakowej energii w pasmach tercjowych
+ *  (szum różowy, przemiatanie logarytmiczne lub zestaw tonów) odtwarzany przez głośnik o płaskiej charakterystyce.
+ *  Dane kalibracyjne (poziom przy 1 kHz) pozostają bez zmian.
+ *  @throw std::logic_error Jeśli urządzenie wejścia dostarcza próbki w nieobsługiwanym formacie.
+ */
+void Calibrator::CalibrateResponse()
+{
+	connect(recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(OnResponseRecordingStopped(const LevelMetrics &)));
+	connect(recorder, SIGNAL(responseMeasured(const QSharedPointer<const FrequencyResponse> &)),
+			this, SLOT(OnResponseMeasured(const QSharedPointer<const FrequencyResponse> &)));
+	measuredResponse.reset();
+	calibrating = true;
+	kind = ResponseCalibration;
+	responseRun = true;
+	recorder->SetResponseMeasurement(true);
+	try
+	{
+		recorder->Start();
+	}
+	catch (exception &)
+	{
+		endRun();
+		disconnect(recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(OnResponseRecordingStopped(const LevelMetrics &)));
+		disconnect(recorder, SIGNAL(responseMeasured(const QSharedPointer<const FrequencyResponse> &)),
+				   this, SLOT(OnResponseMeasured(const QSharedPointer<const FrequencyResponse> &)));
+		throw;
+	}
+}
+/**
+ *  @brief Metoda wyłączająca korekcję charakterystyki częstotliwościowej urządzenia i usuwająca ją z profilu.
+ */
+void Calibrator::ClearResponse()
+{
+	response.reset();
+	recorder->SetResponse(response);
+	storeProfile();
+}
+/**
+ *  @brief Slot zapamiętujący krzywą korekcji zmierzoną przez Recorder tuż przed zakończeniem nagrania.
+ *  @param response Krzywa korekcji; pusty wskaźnik, jeśli w nagraniu nie było sygnału pomiarowego.
+ */
+void Calibrator::OnResponseMeasured(const QSharedPointer<const FrequencyResponse> &response)
+{
+	measuredResponse = response;
+}
+/**
+ *  @brief Metoda kończąca kalibrację charakterystyki: zapisuje krzywą korekcji w profilu urządzenia i przekazuje ją rejestratorowi.
+ *  @param metrics Miary nagrania (nieużywane; krzywą przekazuje OnResponseMeasured).
+ */
+void Calibrator::OnResponseRecordingStopped(const LevelMetrics &metrics)
+{
+	Q_UNUSED(metrics);
+	disconnect(recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(OnResponseRecordingStopped(const LevelMetrics &)));
+	disconnect(recorder, SIGNAL(responseMeasured(const QSharedPointer<const FrequencyResponse> &)),
+			   this, SLOT(OnResponseMeasured(const QSharedPointer<const FrequencyResponse> &)));
+	endRun();
+	accepted = !measuredResponse.isNull();
+	if (accepted)
+	{
+		response = measuredResponse;
+		qDebug() << "Korekcja charakterystyki:" << response->toString();
+		recorder->SetResponse(response);
+		storeProfile();
+	}
+	emit calibrationStopped();
+}
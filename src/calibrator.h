@@ -1,32 +1,147 @@
 #ifndef CALIBRATOR_H
 #define CALIBRATOR_H
 
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QVector>
 #include "recorder.h"
 /**
- * @brief Klasa odpowiadająca za proces kalibracji programu.
+ * @brief Klasa odpowiadająca za proces kalibracji jednego stanowiska (rejestratora z jego urządzeniem wejścia). Wynik każdej kalibracji
+ * zapisywany jest w profilu urządzenia (CalibrationProfiles), a po zmianie urządzenia wczytywany jest jego profil. W trybie adaptacyjnym
+ * nagrywanie sygnału kalibracyjnego kończy się, gdy tylko jego poziom ustali się w zadanej tolerancji, a najpóźniej po czasie maksymalnym.
+ * Kalibracja przyjmowana jest tylko wtedy, gdy ToneDetector wykrył ton 1 kHz; ton wykryty w zwykłym nagraniu służy do sprawdzenia,
+ * czy dane kalibracyjne są nadal aktualne. Osobna kalibracja charakterystyki (CalibrateResponse) wyznacza krzywą korekcji urządzenia,
+ * stosowaną przez rejestrator razem z charakterystyką A.
  * @authors Pavel Mukha Kamil Wasilewski
  */
 class Calibrator : public QObject
 {
     Q_OBJECT
+public:
+	/**
+	 * @brief Rodzaj kalibracji.
+	 */
+	enum Kind
+	{
+		LevelCalibration, /**< Poziom tonu 1 kHz, z którego wyliczane są dane kalibracyjne. */
+		ResponseCalibration /**< Charakterystyka częstotliwościowa, z której wyliczana jest krzywa korekcji. */
+	};
+
+private:
 	Recorder *recorder;
+	double calibrationData;
+	QDateTime calibrationTime;
+	double tolerance;
+	int maxDuration;
+	bool adaptiveRun;
+	int fixedDuration;
+	QElapsedTimer elapsed;
+	int measurementTime;
+	double stability;
+	double stableLevel;
+	bool stable;
+	bool calibrating;
+	bool liveRun;
+	ToneCheck tone;
+	bool accepted;
+	Kind kind;
+	bool responseRun;
+	QSharedPointer<const FrequencyResponse> response;
+	QSharedPointer<const FrequencyResponse> measuredResponse;
+
+	void endRun();
+	void storeProfile() const;
 public:
+	/**
+	 * @brief Czas, przez który poziom musi mieścić się w tolerancji, aby kalibracja adaptacyjna się zakończyła, w milisekundach.
+	 */
+	static const int holdTime = 500;
+	/**
+	 * @brief Odchyłka poziomu tonu kalibracyjnego od 94 dB (po kalibracji), powyżej której zgłaszany jest sygnał calibrationDrifted(), w dB.
+	 */
+	static constexpr double driftTolerance = 0.5;
+
 	explicit Calibrator(Recorder *recorder, QObject *parent = nullptr);
 	void Calibrate();
     void CalibrateFromFile(const QString &fileName);
-
-    static double calibrationData;
+	void CalibrateResponse();
+	void ClearResponse();
+	void SetAdaptive(double tolerance, int maxDuration);
+	/**
+	 * @brief Zwraca tolerancję kalibracji adaptacyjnej.
+	 * @return Tolerancja w decybelach; 0, jeśli sygnał kalibracyjny nagrywany jest przez pełny czas nagrania.
+	 */
+	double Tolerance() const { return tolerance; }
+	/**
+	 * @brief Zwraca maksymalny czas kalibracji adaptacyjnej.
+	 * @return Czas w milisekundach.
+	 */
+	int MaxDuration() const { return maxDuration; }
+	/**
+	 * @brief Zwraca dane kalibracyjne stanowiska.
+	 * @return Poprawka w decybelach dodawana do wyników rejestratora (0.0 przed pierwszą kalibracją).
+	 */
+	double CalibrationData() const { return calibrationData; }
+	/**
+	 * @brief Zwraca czas pomiaru, z którego pochodzą dane kalibracyjne.
+	 * @return Czas pomiaru; nieprawidłowy, jeśli urządzenie nie było kalibrowane.
+	 */
+	QDateTime CalibrationTime() const { return calibrationTime; }
+	/**
+	 * @brief Zwraca stabilność sygnału kalibracyjnego zmierzoną podczas kalibracji.
+	 * @return Największe odchylenie poziomu od poziomu okna w decybelach; ujemne, jeśli nie było mierzone (np. kalibracja z pliku).
+	 */
+	double Stability() const { return stability; }
+	/**
+	 * @brief Sprawdza, czy w ostatniej kalibracji adaptacyjnej poziom ustalił się w tolerancji przed upływem czasu maksymalnego.
+	 * @return true, jeśli poziom się ustalił.
+	 */
+	bool IsStable() const { return stable; }
+	/**
+	 * @brief Zwraca czas nagrywania sygnału kalibracyjnego w ostatniej kalibracji.
+	 * @return Czas w milisekundach; 0 dla kalibracji z pliku.
+	 */
+	int MeasurementTime() const { return measurementTime; }
+	/**
+	 * @brief Zwraca wynik sprawdzenia tonu kalibracyjnego w ostatniej kalibracji.
+	 * @return Częstotliwość, czystość i poziom tonu (bez danych kalibracyjnych).
+	 */
+	ToneCheck Tone() const { return tone; }
+	/**
+	 * @brief Sprawdza, czy ostatnia kalibracja została przyjęta. Kalibracja bez tonu kalibracyjnego nie zmienia danych kalibracyjnych.
+	 * @return true, jeśli wyliczono nowe dane kalibracyjne.
+	 */
+	bool IsAccepted() const { return accepted; }
+	/**
+	 * @brief Zwraca rodzaj ostatniej kalibracji.
+	 * @return Rodzaj kalibracji.
+	 */
+	Kind LastKind() const { return kind; }
+	/**
+	 * @brief Zwraca krzywą korekcji charakterystyki częstotliwościowej urządzenia.
+	 * @return Krzywa korekcji; pusty wskaźnik, jeśli charakterystyka nie była mierzona.
+	 */
+	QSharedPointer<const FrequencyResponse> Response() const { return response; }
 signals:
     /**
       * @brief Sygnał kończący kalibrację.
       * @authors Pavel Mukha
       */
 	void calibrationStopped();
+	/**
+	 * @brief Sygnał wysyłany, gdy w nagraniu poza kalibracją wykryto ton kalibracyjny o poziomie innym niż 94 dB po kalibracji.
+	 * @param drift Różnica poziomu tonu (z danymi kalibracyjnymi) i 94 dB w decybelach.
+	 */
+	void calibrationDrifted(double drift);
 
 public slots:
-	void OnRecordingStopped(const QVector<std::complex<double> > &x);
+	void OnRecordingStopped(const LevelMetrics &metrics);
+	void OnStabilityMeasured(double level, double deviation, bool stable);
+	void OnToneMeasured(const ToneCheck &tone);
+	void OnResponseMeasured(const QSharedPointer<const FrequencyResponse> &response);
+	void OnResponseRecordingStopped(const LevelMetrics &metrics);
+	void LoadProfile();
 };
 
 #endif // CALIBRATOR_H
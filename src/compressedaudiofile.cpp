@@ -0,0 +1,113 @@
+#include "compressedaudiofile.h"
+#include "losslesscodec.h"
+#include <QtEndian>
+#include <cstring>
+
+/**
+ * @brief Destruktor. Zamyka plik, uzupełniając nagłówek.
+ */
+CompressedAudioFile::~CompressedAudioFile()
+{
+	if (isOpen())
+		close();
+}
+/**
+ * @brief Metoda otwierająca plik do zapisu i zapisująca nagłówek z pustymi polami.
+ * @param flags Tryb otwarcia; plik może być tylko zapisywany.
+ * @return Czy plik został otwarty.
+ */
+bool CompressedAudioFile::open(OpenMode flags)
+{
+	if (format.sampleSize() != 16 || format.sampleType() != QAudioFormat::SignedInt || format.channelCount() != 1
+			|| (flags & QIODevice::ReadOnly))
+	{
+		setErrorString(tr("Archiwum obsługuje tylko zapis próbek 16-bitowych mono. "));
+		return false;
+	}
+	if (!file.open(flags))
+	{
+		setErrorString(file.errorString());
+		return false;
+	}
+	pending.clear();
+	offsets.clear();
+	frames = 0;
+	file.write(QByteArray(headerSize, '\0'));
+	return QIODevice::open(flags);
+}
+/**
+ * @brief Metoda przyjmująca próbki PCM i kodująca każdy pełny blok.
+ * @param data Próbki PCM, 16 bitów, little endian.
+ * @param size Liczba bajtów.
+ * @return Liczba przyjętych bajtów lub -1 w razie błędu zapisu.
+ */
+qint64 CompressedAudioFile::writeData(const char *data, qint64 size)
+{
+	pending.append(data, (int) size);
+	const int blockBytes = blockSize * (int) sizeof(qint16);
+	int done = 0;
+	for (; pending.size() - done >= blockBytes; done += blockBytes)
+		writeBlock(reinterpret_cast<const qint16 *>(pending.constData() + done), blockSize);
+	pending.remove(0, done);
+	return file.error() == QFile::NoError ? size : -1;
+}
+/**
+ * @brief Plik służy tylko do zapisu.
+ * @return -1.
+ */
+qint64 CompressedAudioFile::readData(char *data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+	return -1;
+}
+/**
+ * @brief Metoda kodująca i zapisująca jeden blok.
+ * @param samples Próbki (little endian, czyli w kolejności bajtów procesora x86).
+ * @param count Liczba próbek.
+ */
+void CompressedAudioFile::writeBlock(const qint16 *samples, int count)
+{
+	block.resize(count);
+	for (int i = 0; i < count; ++i)
+		block[i] = qFromLittleEndian<qint16>(samples + i);
+	offsets.append((quint64) file.pos());
+	encoded.clear();
+	LosslessCodec::encodeBlock(block.constData(), count, encoded);
+	file.write(encoded);
+	frames += count;
+}
+/**
+ * @brief Metoda kodująca ostatni, niepełny blok, zapisująca indeks, uzupełniająca nagłówek i zamykająca plik.
+ */
+void CompressedAudioFile::close()
+{
+	if (!isOpen())
+		return;
+	if (pending.size() >= (int) sizeof(qint16))
+		writeBlock(reinterpret_cast<const qint16 *>(pending.constData()), pending.size() / (int) sizeof(qint16));
+	pending.clear();
+
+	const quint64 indexOffset = (quint64) file.pos();
+	uchar field[8];
+	qToLittleEndian<quint32>((quint32) offsets.size(), field);
+	file.write(reinterpret_cast<const char *>(field), 4);
+	for (quint64 offset : offsets)
+	{
+		qToLittleEndian<quint64>(offset, field);
+		file.write(reinterpret_cast<const char *>(field), 8);
+	}
+
+	uchar header[headerSize];
+	std::memcpy(header, "KKA1", 4);
+	qToLittleEndian<quint32>((quint32) format.sampleRate(), header + 4);
+	qToLittleEndian<quint16>((quint16) format.channelCount(), header + 8);
+	qToLittleEndian<quint16>((quint16) format.sampleSize(), header + 10);
+	qToLittleEndian<quint32>((quint32) blockSize, header + 12);
+	qToLittleEndian<quint64>(frames, header + 16);
+	qToLittleEndian<quint64>(indexOffset, header + 24);
+	file.seek(0);
+	file.write(reinterpret_cast<const char *>(header), headerSize);
+	file.close();
+	QIODevice::close();
+}
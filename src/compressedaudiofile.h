@@ -0,0 +1,54 @@
+#ifndef COMPRESSEDAUDIOFILE_H
+#define COMPRESSEDAUDIOFILE_H
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QVector>
+
+/**
+ * @brief Plik archiwum nagrań (*.kka) z bezstratną kompresją LosslessCodec. Zapisuje się go jak WavFile: próbki PCM
+ * (16 bitów, mono, little endian) przekazywane są przez write(), a nagłówek i indeks bloków uzupełniane są przy zamknięciu.
+ * Indeks pozwala zdekodować dowolny fragment nagrania bez czytania całego pliku (WavReader).
+ *
+ * Układ pliku (little endian): "KKA1", częstotliwość próbkowania (4 B), liczba kanałów (2 B), bity na próbkę (2 B),
+ * liczba próbek w bloku (4 B), liczba próbek (8 B), położenie indeksu (8 B), bloki, a na końcu indeks: liczba bloków (4 B)
+ * i położenie każdego bloku (po 8 B). Blok kończy się tam, gdzie zaczyna następny lub indeks.
+ */
+class CompressedAudioFile : public QIODevice
+{
+	Q_OBJECT
+	QFile file;
+	QAudioFormat format;
+	QByteArray pending;
+	QByteArray encoded;
+	QVector<qint16> block;
+	QVector<quint64> offsets;
+	quint64 frames;
+
+	void writeBlock(const qint16 *samples, int count);
+protected:
+	qint64 readData(char *data, qint64 maxSize) override;
+	qint64 writeData(const char *data, qint64 size) override;
+public:
+	/**
+	 * @brief Liczba próbek w bloku (ok. 85 ms przy 48 kHz).
+	 */
+	static const int blockSize = 4096;
+	/**
+	 * @brief Rozmiar nagłówka w bajtach.
+	 */
+	static const int headerSize = 32;
+
+	CompressedAudioFile() {}
+	~CompressedAudioFile();
+	void setFileName(const QString &name) { file.setFileName(name); }
+	QString fileName() const { return file.fileName(); }
+	void setAudioFormat(const QAudioFormat &format) { this->format = format; }
+	bool isSequential() const override { return true; }
+	bool open(OpenMode flags) override;
+	void close() override;
+};
+
+#endif // COMPRESSEDAUDIOFILE_H
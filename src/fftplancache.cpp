@@ -0,0 +1,402 @@
+#include "fftplancache.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QStandardPaths>
+
+/**
+ * @brief Maksymalny czas (w sekundach), jaki planer FFTW może poświęcić na mierzenie jednego planu.
+ */
+static const double planningTimeLimit = 2.0;
+/**
+ * @brief Maksymalna liczba nieużywanych planów przechowywanych jednocześnie w pamięci podręcznej.
+ */
+static const int maxCachedPlans = 8;
+
+/**
+ * @brief Pobiera z pamięci podręcznej plan dla transformaty o podanym rozmiarze i rodzaju (tworząc go w razie potrzeby) i blokuje go na wyłączność.
+ * @param size Liczba próbek wejściowych.
+ * @param kind Rodzaj transformaty.
+ */
+FftPlanCache::Lease::Lease(int size, Kind kind) : plan(FftPlanCache::instance().acquire(size, kind))
+{
+	plan->mutex.lock();
+}
+/**
+ * @brief Zwalnia blokadę planu i oddaje go pamięci podręcznej.
+ */
+FftPlanCache::Lease::~Lease()
+{
+	plan->mutex.unlock();
+	FftPlanCache::instance().release(plan);
+}
+/**
+ * @brief Zwraca wyrównany bufor wejściowy planu zespolonego.
+ * @return Bufor o długości równej rozmiarowi transformaty.
+ */
+fftw_complex *FftPlanCache::Lease::complexIn() const
+{
+	return static_cast<fftw_complex *>(plan->in);
+}
+/**
+ * @brief Zwraca wyrównany bufor wyjściowy planu.
+ * @return Bufor o długości równej rozmiarowi transformaty, a dla planu RealForward o długości size / 2 + 1.
+ */
+fftw_complex *FftPlanCache::Lease::complexOut() const
+{
+	return static_cast<fftw_complex *>(plan->out);
+}
+/**
+ * @brief Zwraca wyrównany bufor wejściowy planu rzeczywistego (RealForward).
+ * @return Bufor o długości równej rozmiarowi transformaty.
+ */
+double *FftPlanCache::Lease::realIn() const
+{
+	return static_cast<double *>(plan->in);
+}
+#ifdef KK_SINGLE_PRECISION
+/**
+ * @brief Zwraca wyrównany bufor wejściowy planu rzeczywistego w pojedynczej precyzji (RealForwardFloat).
+ * @return Bufor o długości równej rozmiarowi transformaty.
+ */
+float *FftPlanCache::Lease::floatIn() const
+{
+	return static_cast<float *>(plan->in);
+}
+/**
+ * @brief Zwraca wyrównany bufor wyjściowy planu w pojedynczej precyzji (RealForwardFloat).
+ * @return Bufor o długości size / 2 + 1.
+ */
+fftwf_complex *FftPlanCache::Lease::floatOut() const
+{
+	return static_cast<fftwf_complex *>(plan->out);
+}
+#endif
+/**
+ * @brief Wykonuje transformatę na buforach planu.
+ */
+void FftPlanCache::Lease::execute() const
+{
+#ifdef KK_SINGLE_PRECISION
+	if (plan->kind == RealForwardFloat)
+	{
+		fftwf_execute(plan->floatHandle);
+		return;
+	}
+#endif
+	fftw_execute(plan->handle);
+}
+
+/**
+ * @brief Pobiera z pamięci podręcznej plan dla transformaty o podanym rozmiarze i rodzaju (tworząc go w razie potrzeby) i przydziela
+ * własne bufory o takim samym wyrównaniu jak bufory planu.
+ * @param size Liczba próbek wejściowych.
+ * @param kind Rodzaj transformaty.
+ */
+FftPlanCache::Binding::Binding(int size, Kind kind) : plan(FftPlanCache::instance().acquire(size, kind))
+{
+#ifdef KK_SINGLE_PRECISION
+	if (kind == RealForwardFloat)
+	{
+		in = fftwf_malloc(sizeof(float) * size);
+		out = fftwf_malloc(sizeof(fftwf_complex) * (size / 2 + 1));
+	}
+	else
+#endif
+	if (kind == RealForward)
+	{
+		in = fftw_malloc(sizeof(double) * size);
+		out = fftw_malloc(sizeof(fftw_complex) * (size / 2 + 1));
+	}
+	else
+	{
+		in = fftw_malloc(sizeof(fftw_complex) * size);
+		out = fftw_malloc(sizeof(fftw_complex) * size);
+	}
+}
+/**
+ * @brief Zwalnia bufory i oddaje plan pamięci podręcznej.
+ */
+FftPlanCache::Binding::~Binding()
+{
+#ifdef KK_SINGLE_PRECISION
+	if (plan->kind == RealForwardFloat)
+	{
+		fftwf_free(in);
+		fftwf_free(out);
+	}
+	else
+#endif
+	{
+		fftw_free(in);
+		fftw_free(out);
+	}
+	FftPlanCache::instance().release(plan);
+}
+/**
+ * @brief Zwraca bufor wejściowy planu rzeczywistego (RealForward).
+ * @return Bufor o długości równej rozmiarowi transformaty.
+ */
+double *FftPlanCache::Binding::realIn() const
+{
+	return static_cast<double *>(in);
+}
+/**
+ * @brief Zwraca bufor wejściowy planu zespolonego.
+ * @return Bufor o długości równej rozmiarowi transformaty.
+ */
+fftw_complex *FftPlanCache::Binding::complexIn() const
+{
+	return static_cast<fftw_complex *>(in);
+}
+/**
+ * @brief Zwraca bufor wyjściowy planu.
+ * @return Bufor o długości równej rozmiarowi transformaty, a dla planu RealForward o długości size / 2 + 1.
+ */
+fftw_complex *FftPlanCache::Binding::complexOut() const
+{
+	return static_cast<fftw_complex *>(out);
+}
+#ifdef KK_SINGLE_PRECISION
+/**
+ * @brief Zwraca bufor wejściowy planu rzeczywistego w pojedynczej precyzji (RealForwardFloat).
+ * @return Bufor o długości równej rozmiarowi transformaty.
+ */
+float *FftPlanCache::Binding::floatIn() const
+{
+	return static_cast<float *>(in);
+}
+/**
+ * @brief Zwraca bufor wyjściowy planu w pojedynczej precyzji (RealForwardFloat).
+ * @return Bufor o długości size / 2 + 1.
+ */
+fftwf_complex *FftPlanCache::Binding::floatOut() const
+{
+	return static_cast<fftwf_complex *>(out);
+}
+#endif
+/**
+ * @brief Zwraca rodzaj transformaty.
+ * @return Rodzaj planu.
+ */
+FftPlanCache::Kind FftPlanCache::Binding::kind() const
+{
+	return plan->kind;
+}
+/**
+ * @brief Zwraca rozmiar transformaty.
+ * @return Liczba próbek wejściowych planu.
+ */
+int FftPlanCache::Binding::size() const
+{
+	return plan->length;
+}
+/**
+ * @brief Wykonuje transformatę na buforach obiektu. Plan nie jest blokowany, bo wykonanie na innych buforach nie zmienia planu.
+ */
+void FftPlanCache::Binding::execute() const
+{
+	switch (plan->kind)
+	{
+#ifdef KK_SINGLE_PRECISION
+	case RealForwardFloat:
+		fftwf_execute_dft_r2c(plan->floatHandle, floatIn(), floatOut());
+		break;
+#endif
+	case RealForward:
+		fftw_execute_dft_r2c(plan->handle, realIn(), complexOut());
+		break;
+	default:
+		fftw_execute_dft(plan->handle, complexIn(), complexOut());
+		break;
+	}
+}
+
+/**
+ * @brief Zwraca jedyną instancję pamięci podręcznej planów.
+ * @return Pamięć podręczna planów współdzielona przez cały program.
+ */
+FftPlanCache &FftPlanCache::instance()
+{
+	static FftPlanCache cache;
+	return cache;
+}
+/**
+ * @brief Konstruktor. Wczytuje zapisaną na dysku mądrość FFTW.
+ */
+FftPlanCache::FftPlanCache() : hitCount(0), missCount(0), useCounter(0)
+{
+	QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+	if (dir.isEmpty())
+		dir = QCoreApplication::applicationDirPath();
+	QDir().mkpath(dir);
+	wisdomFileName = QDir(dir).filePath("fftw.wisdom");
+
+	fftw_set_timelimit(planningTimeLimit);
+	if (!fftw_import_wisdom_from_filename(QFile::encodeName(wisdomFileName).constData()))
+		qDebug() << "No FFTW wisdom loaded from" << wisdomFileName;
+#ifdef KK_SINGLE_PRECISION
+	floatWisdomFileName = QDir(dir).filePath("fftwf.wisdom");
+	fftwf_set_timelimit(planningTimeLimit);
+	// Single precision plans have their own wisdom; it is only present once such plans have been used.
+	fftwf_import_wisdom_from_filename(QFile::encodeName(floatWisdomFileName).constData());
+#endif
+}
+/**
+ * @brief Destruktor. Niszczy wszystkie plany i zwalnia ich bufory.
+ */
+FftPlanCache::~FftPlanCache()
+{
+	for (auto plan : plans)
+		destroyPlan(plan);
+}
+/**
+ * @brief Zwraca plan dla transformaty o podanym rozmiarze i rodzaju. Jeśli planu nie ma w pamięci podręcznej, zostaje on utworzony.
+ * @param size Liczba próbek wejściowych.
+ * @param kind Rodzaj transformaty.
+ * @return Plan należący do pamięci podręcznej, oznaczony jako używany do czasu wywołania release().
+ */
+FftPlanCache::Plan *FftPlanCache::acquire(int size, Kind kind)
+{
+	QMutexLocker locker(&mutex);
+	const Key key(size, kind);
+	Plan *plan = plans.value(key, nullptr);
+	if (plan != nullptr)
+		++hitCount;
+	else
+	{
+		++missCount;
+		plan = createPlan(size, kind);
+		plans.insert(key, plan);
+		saveWisdom(kind);
+	}
+	++plan->leases;
+	plan->lastUse = ++useCounter;
+	evictUnusedPlans();
+	return plan;
+}
+/**
+ * @brief Oznacza plan jako nieużywany.
+ * @param plan Plan pobrany wcześniej metodą acquire().
+ */
+void FftPlanCache::release(Plan *plan)
+{
+	QMutexLocker locker(&mutex);
+	--plan->leases;
+}
+/**
+ * @brief Usuwa najdawniej używane plany, które nie są w tej chwili wykorzystywane, aż w pamięci podręcznej zostanie co najwyżej maxCachedPlans planów.
+ */
+void FftPlanCache::evictUnusedPlans()
+{
+	while (plans.size() > maxCachedPlans)
+	{
+		auto oldest = plans.end();
+		for (auto it = plans.begin(); it != plans.end(); ++it)
+		{
+			if (it.value()->leases == 0 && (oldest == plans.end() || it.value()->lastUse < oldest.value()->lastUse))
+				oldest = it;
+		}
+		if (oldest == plans.end())
+			return;
+		destroyPlan(oldest.value());
+		plans.erase(oldest);
+	}
+}
+/**
+ * @brief Tworzy nowy plan wraz z buforami. Wywoływana z zablokowanym muteksem, ponieważ planer FFTW nie jest bezpieczny wątkowo.
+ * @param size Liczba próbek wejściowych.
+ * @param kind Rodzaj transformaty.
+ * @return Nowy plan.
+ */
+FftPlanCache::Plan *FftPlanCache::createPlan(int size, Kind kind)
+{
+	Plan *plan = new Plan;
+	plan->length = size;
+	plan->kind = kind;
+	// FFTW_MEASURE overwrites the buffers, which is fine: they are filled right before every execution.
+#ifdef KK_SINGLE_PRECISION
+	if (kind == RealForwardFloat)
+	{
+		plan->in = fftwf_malloc(sizeof(float) * size);
+		plan->out = fftwf_malloc(sizeof(fftwf_complex) * (size / 2 + 1));
+		plan->floatHandle = fftwf_plan_dft_r2c_1d(size, static_cast<float *>(plan->in), static_cast<fftwf_complex *>(plan->out),
+												  FFTW_MEASURE);
+	}
+	else
+#endif
+	if (kind == RealForward)
+	{
+		plan->in = fftw_malloc(sizeof(double) * size);
+		plan->out = fftw_malloc(sizeof(fftw_complex) * (size / 2 + 1));
+		plan->handle = fftw_plan_dft_r2c_1d(size, static_cast<double *>(plan->in), static_cast<fftw_complex *>(plan->out),
+											FFTW_MEASURE);
+	}
+	else
+	{
+		plan->in = fftw_malloc(sizeof(fftw_complex) * size);
+		plan->out = fftw_malloc(sizeof(fftw_complex) * size);
+		plan->handle = fftw_plan_dft_1d(size, static_cast<fftw_complex *>(plan->in), static_cast<fftw_complex *>(plan->out),
+										FFTW_FORWARD, FFTW_MEASURE);
+	}
+	return plan;
+}
+/**
+ * @brief Niszczy plan i zwalnia jego bufory.
+ * @param plan Plan należący do pamięci podręcznej.
+ */
+void FftPlanCache::destroyPlan(Plan *plan)
+{
+#ifdef KK_SINGLE_PRECISION
+	if (plan->kind == RealForwardFloat)
+	{
+		fftwf_destroy_plan(plan->floatHandle);
+		fftwf_free(plan->in);
+		fftwf_free(plan->out);
+	}
+	else
+#endif
+	{
+		fftw_destroy_plan(plan->handle);
+		fftw_free(plan->in);
+		fftw_free(plan->out);
+	}
+	delete plan;
+}
+/**
+ * @brief Zapisuje mądrość FFTW na dysku, aby kolejne uruchomienia programu nie musiały ponownie mierzyć planów.
+ * @param kind Rodzaj nowo utworzonego planu; plany w pojedynczej precyzji mają osobny plik mądrości.
+ */
+void FftPlanCache::saveWisdom(Kind kind) const
+{
+#ifdef KK_SINGLE_PRECISION
+	if (kind == RealForwardFloat)
+	{
+		if (!fftwf_export_wisdom_to_filename(QFile::encodeName(floatWisdomFileName).constData()))
+			qDebug() << "Could not save FFTW wisdom to" << floatWisdomFileName;
+		return;
+	}
+#else
+	Q_UNUSED(kind);
+#endif
+	if (!fftw_export_wisdom_to_filename(QFile::encodeName(wisdomFileName).constData()))
+		qDebug() << "Could not save FFTW wisdom to" << wisdomFileName;
+}
+/**
+ * @brief Zwraca liczbę zapytań, dla których plan znajdował się już w pamięci podręcznej.
+ * @return Liczba trafień.
+ */
+int FftPlanCache::hits() const
+{
+	QMutexLocker locker(&mutex);
+	return hitCount;
+}
+/**
+ * @brief Zwraca liczbę zapytań, dla których plan musiał zostać utworzony.
+ * @return Liczba chybień.
+ */
+int FftPlanCache::misses() const
+{
+	QMutexLocker locker(&mutex);
+	return missCount;
+}
@@ -0,0 +1,139 @@
+#ifndef FFTPLANCACHE_H
+#define FFTPLANCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QtGlobal>
+#include <fftw3.h>
+
+/**
+ * @brief Pamięć podręczna planów FFTW. Plan wraz z wyrównanymi buforami wejścia i wyjścia tworzony jest tylko raz dla danego rozmiaru
+ * i rodzaju transformaty, a następnie używany ponownie przy każdym kolejnym wyniku. Mądrość (wisdom) FFTW zapisywana jest na dysku,
+ * dzięki czemu plany jakości FFTW_MEASURE po ponownym uruchomieniu programu nie wymagają kosztownego mierzenia.
+ */
+class FftPlanCache
+{
+public:
+	/**
+	 * @brief Rodzaj transformaty, dla której tworzony jest plan.
+	 */
+	enum Kind
+	{
+		ComplexForward, /**< Zespolona transformata w przód (fftw_plan_dft_1d, FFTW_FORWARD). */
+		RealForward /**< Transformata sygnału rzeczywistego (fftw_plan_dft_r2c_1d), zwraca size / 2 + 1 prążków. */
+#ifdef KK_SINGLE_PRECISION
+		, RealForwardFloat /**< Jak RealForward, ale w pojedynczej precyzji (fftwf_plan_dft_r2c_1d). */
+#endif
+	};
+
+	class Plan;
+	/**
+	 * @brief Dostęp na wyłączność do planu z pamięci podręcznej. Blokuje plan na czas swojego życia, więc bufory planu
+	 * mogą być bezpiecznie wypełnione i przetransformowane, a sam plan nie zostanie w tym czasie usunięty z pamięci podręcznej.
+	 */
+	class Lease
+	{
+		Plan *plan;
+	public:
+		Lease(int size, Kind kind);
+		~Lease();
+		Lease(const Lease &) = delete;
+		Lease &operator=(const Lease &) = delete;
+
+		fftw_complex *complexIn() const;
+		fftw_complex *complexOut() const;
+		double *realIn() const;
+#ifdef KK_SINGLE_PRECISION
+		float *floatIn() const;
+		fftwf_complex *floatOut() const;
+#endif
+		void execute() const;
+	};
+	/**
+	 * @brief Plan z pamięci podręcznej przypięty na cały czas życia obiektu i wykonywany na własnych, wyrównanych buforach obiektu
+	 * (funkcje new-array FFTW, które są bezpieczne wątkowo). Pamięć podręczna blokowana jest tylko w konstruktorze i destruktorze,
+	 * więc wątki analizy kilku stanowisk wykonują ten sam plan jednocześnie, bez wzajemnego oczekiwania.
+	 */
+	class Binding
+	{
+		Plan *plan;
+		void *in;
+		void *out;
+	public:
+		Binding(int size, Kind kind);
+		~Binding();
+		Binding(const Binding &) = delete;
+		Binding &operator=(const Binding &) = delete;
+
+		double *realIn() const;
+		fftw_complex *complexIn() const;
+		fftw_complex *complexOut() const;
+#ifdef KK_SINGLE_PRECISION
+		float *floatIn() const;
+		fftwf_complex *floatOut() const;
+#endif
+		Kind kind() const;
+		int size() const;
+		void execute() const;
+	};
+
+	static FftPlanCache &instance();
+	int hits() const;
+	int misses() const;
+
+private:
+	typedef QPair<int, int> Key;
+
+	QHash<Key, Plan *> plans;
+	mutable QMutex mutex;
+	QString wisdomFileName;
+#ifdef KK_SINGLE_PRECISION
+	QString floatWisdomFileName;
+#endif
+	int hitCount;
+	int missCount;
+	quint64 useCounter;
+
+	FftPlanCache();
+	~FftPlanCache();
+	FftPlanCache(const FftPlanCache &) = delete;
+	FftPlanCache &operator=(const FftPlanCache &) = delete;
+
+	Plan *acquire(int size, Kind kind);
+	void release(Plan *plan);
+	Plan *createPlan(int size, Kind kind);
+	void destroyPlan(Plan *plan);
+	void evictUnusedPlans();
+	void saveWisdom(Kind kind) const;
+};
+
+/**
+ * @brief Plan FFTW wraz z buforami, do których jest przypisany. Obiekty tworzy i niszczy wyłącznie FftPlanCache.
+ */
+class FftPlanCache::Plan
+{
+	friend class FftPlanCache;
+	friend class FftPlanCache::Lease;
+
+	fftw_plan handle;
+	fftwf_plan floatHandle;
+	int length;
+	Kind kind;
+	void *in;
+	void *out;
+	QMutex mutex;
+	int leases;
+	quint64 lastUse;
+
+	Plan() : handle(nullptr), floatHandle(nullptr), length(0), kind(ComplexForward), in(nullptr), out(nullptr), leases(0), lastUse(0) {}
+public:
+	/**
+	 * @brief Zwraca rozmiar transformaty.
+	 * @return Liczba próbek wejściowych planu.
+	 */
+	int size() const { return length; }
+};
+
+#endif // FFTPLANCACHE_H
@@ -0,0 +1,127 @@
+#include "frequencyresponse.h"
+#include <QAtomicInt>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Licznik nadający numery kolejnym krzywym.
+ */
+static QAtomicInt serials;
+
+/**
+ * @brief Konstruktor.
+ * @param corrections Poprawki kolejnych pasm w decybelach (bandCount wartości).
+ */
+FrequencyResponse::FrequencyResponse(const QVector<float> &corrections) : corrections(corrections),
+	serial(serials.fetchAndAddRelaxed(1) + 1)
+{
+	this->corrections.resize(bandCount);
+}
+/**
+ * @brief Zwraca częstotliwość środkową pasma tercjowego (szereg dziesiętny, 10^(n/10) Hz).
+ * @param band Indeks pasma, od 0 (20 Hz) do bandCount - 1 (20 kHz).
+ * @return Częstotliwość w Hz.
+ */
+double FrequencyResponse::bandCentre(int band)
+{
+	return std::pow(10.0, (13 + band) / 10.0);
+}
+/**
+ * @brief Metoda wyznaczająca krzywą korekcji z widma nagrania sygnału o jednakowej energii w każdym paśmie tercjowym
+ * (szum różowy, przemiatanie logarytmiczne albo po jednym tonie o tej samej amplitudzie na pasmo) odtwarzanego przez głośnik
+ * o płaskiej charakterystyce. Poprawka pasma to stosunek energii pasma 1 kHz do energii pasma. Pasma bez prążków albo o energii
+ * mniejszej o ponad 60 dB od pasma 1 kHz przyjmują poprawkę najbliższego zmierzonego pasma.
+ * @param binEnergy Energia kolejnych prążków widma jednostronnego (size / 2 + 1 wartości).
+ * @param size Rozmiar transformaty.
+ * @param sampleRate Częstotliwość próbkowania w Hz.
+ * @return Krzywa korekcji; pusty wskaźnik, jeśli w paśmie 1 kHz nie było sygnału.
+ */
+QSharedPointer<const FrequencyResponse> FrequencyResponse::measure(const double *binEnergy, int size, int sampleRate)
+{
+	QVector<double> energy(bandCount, 0.0);
+	const int bins = size / 2 + 1;
+	const double halfBand = std::pow(10.0, 0.05);
+	for (int band = 0; band < bandCount; ++band)
+	{
+		const double centre = bandCentre(band);
+		const int first = (int) std::ceil(centre / halfBand * size / sampleRate);
+		const int last = std::min((int) std::ceil(centre * halfBand * size / sampleRate), bins);
+		for (int i = std::max(first, 1); i < last; ++i)
+			energy[band] += binEnergy[i];
+	}
+	const double reference = energy[referenceBand];
+	if (reference <= 0.0)
+		return QSharedPointer<const FrequencyResponse>();
+
+	auto measured = [&](int band) { return energy[band] > reference * 1e-6; };
+	const double limit = maxCorrection;
+	QVector<float> corrections(bandCount);
+	for (int band = 0; band < bandCount; ++band)
+	{
+		if (measured(band))
+			corrections[band] = (float) std::max(-limit, std::min(limit, 10.0 * std::log10(reference / energy[band])));
+	}
+	for (int band = 0; band < bandCount; ++band)
+	{
+		if (measured(band))
+			continue;
+		int nearest = -1;
+		for (int d = 1; d < bandCount && nearest < 0; ++d)
+		{
+			if (band - d >= 0 && measured(band - d))
+				nearest = band - d;
+			else if (band + d < bandCount && measured(band + d))
+				nearest = band + d;
+		}
+		corrections[band] = corrections[nearest]; // The reference band is always measured.
+	}
+	return QSharedPointer<const FrequencyResponse>(new FrequencyResponse(corrections));
+}
+/**
+ * @brief Metoda odtwarzająca krzywą zapisaną przez toString().
+ * @param text Poprawki pasm rozdzielone przecinkami.
+ * @return Krzywa korekcji; pusty wskaźnik, jeśli tekst jest pusty albo ma inną liczbę pasm.
+ */
+QSharedPointer<const FrequencyResponse> FrequencyResponse::fromString(const QString &text)
+{
+	const QStringList values = text.split(",");
+	if (values.size() != bandCount)
+		return QSharedPointer<const FrequencyResponse>();
+	QVector<float> corrections(bandCount);
+	for (int band = 0; band < bandCount; ++band)
+		corrections[band] = values[band].toFloat();
+	return QSharedPointer<const FrequencyResponse>(new FrequencyResponse(corrections));
+}
+/**
+ * @brief Zwraca krzywą w postaci tekstowej, do zapisania w profilu kalibracji.
+ * @return Poprawki pasm w decybelach (z dokładnością do 0.01 dB) rozdzielone przecinkami.
+ */
+QString FrequencyResponse::toString() const
+{
+	QStringList values;
+	for (float correction : corrections)
+		values << QString::number(correction, 'f', 2);
+	return values.join(",");
+}
+/**
+ * @brief Zwraca poprawkę dla podanej częstotliwości. Poniżej 20 Hz i powyżej 20 kHz obowiązuje poprawka skrajnego pasma.
+ * @param frequency Częstotliwość w Hz.
+ * @return Wzmocnienie mocy (nie w dB), przez które mnożona jest energia prążka.
+ */
+double FrequencyResponse::gain(double frequency) const
+{
+	const double position = frequency > 0.0 ? 10.0 * std::log10(frequency) - 13.0 : 0.0;
+	double correction;
+	if (position <= 0.0)
+		correction = corrections.first();
+	else if (position >= bandCount - 1)
+		correction = corrections.last();
+	else
+	{
+		const int band = (int) position;
+		const double t = position - band;
+		correction = corrections[band] * (1.0 - t) + corrections[band + 1] * t;
+	}
+	return std::pow(10.0, correction / 10.0);
+}
@@ -0,0 +1,53 @@
+#ifndef FREQUENCYRESPONSE_H
+#define FREQUENCYRESPONSE_H
+
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Krzywa korekcji charakterystyki częstotliwościowej urządzenia wejścia, przechowywana zwięźle jako poprawki w decybelach
+ * dla bandCount pasm tercjowych od 20 Hz do 20 kHz. Poprawka jest unormowana do 0 dB w paśmie 1 kHz, bo bezwzględny poziom ustala
+ * kalibracja tonem 1 kHz. Między środkami pasm poprawka jest interpolowana liniowo względem logarytmu częstotliwości.
+ * WeightingTable mnoży przez nią wagi charakterystyki A, więc korekcja nie zwiększa kosztu sumowania prążków.
+ */
+class FrequencyResponse
+{
+	QVector<float> corrections;
+	int serial;
+public:
+	/**
+	 * @brief Liczba pasm tercjowych (środki od 20 Hz do 20 kHz).
+	 */
+	static const int bandCount = 31;
+	/**
+	 * @brief Indeks pasma 1 kHz, względem którego unormowane są poprawki.
+	 */
+	static const int referenceBand = 17;
+	/**
+	 * @brief Największa poprawka (co do wartości bezwzględnej) w decybelach.
+	 */
+	static constexpr double maxCorrection = 20.0;
+
+	explicit FrequencyResponse(const QVector<float> &corrections);
+	static double bandCentre(int band);
+	static QSharedPointer<const FrequencyResponse> measure(const double *binEnergy, int size, int sampleRate);
+	static QSharedPointer<const FrequencyResponse> fromString(const QString &text);
+	QString toString() const;
+	double gain(double frequency) const;
+	/**
+	 * @brief Zwraca poprawki kolejnych pasm.
+	 * @return Poprawki w decybelach, bandCount wartości.
+	 */
+	const QVector<float> &bands() const { return corrections; }
+	/**
+	 * @brief Zwraca numer krzywej, różny dla każdego utworzonego obiektu; służy jako klucz tablic wag w pamięci podręcznej.
+	 * @return Numer krzywej (większy od 0).
+	 */
+	int id() const { return serial; }
+};
+
+Q_DECLARE_METATYPE(QSharedPointer<const FrequencyResponse>)
+
+#endif // FREQUENCYRESPONSE_H
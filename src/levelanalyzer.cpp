@@ -0,0 +1,156 @@
+#include "levelanalyzer.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Rodzaj planu FFT zgodny z typem próbek.
+ */
+#ifdef KK_SINGLE_PRECISION
+static const FftPlanCache::Kind frameTransform = FftPlanCache::RealForwardFloat;
+#else
+static const FftPlanCache::Kind frameTransform = FftPlanCache::RealForward;
+#endif
+
+/**
+ * @brief Konstruktor. Przydziela bufory ramki i okna 1 s oraz przypina plan FFT i tablicę wag dla rozmiaru ramki.
+ */
+LevelAnalyzer::LevelAnalyzer() : frame(frameSize), transform(frameSize, frameTransform),
+	weighting(WeightingTable::get(AudioModel::sampleRate(), frameSize)), engine(AudioModel::FftEngine), filter(AudioModel::sampleRate()),
+	fastWeighting(TimeWeighting::fast, AudioModel::sampleRate()), window(AudioModel::sampleRate())
+{
+	reset();
+}
+/**
+ * @brief Metoda przygotowująca obiekt do nowego pomiaru. Krzywa korekcji ustawiona przez setResponse jest uwzględniana od tego wywołania,
+ * więc jej zmiana w trakcie nagrywania nie wpływa na bieżący pomiar.
+ */
+void LevelAnalyzer::reset()
+{
+	if (weighting->response() != response)
+		weighting = WeightingTable::get(AudioModel::sampleRate(), frameSize, response);
+	filled = 0;
+	spectrumEnergy = 0.0;
+	sampleCount = 0;
+	leadIn = 0;
+	filter.reset();
+	fastWeighting.reset();
+	filteredEnergy = 0.0;
+	fastMax = 0.0;
+	peakSquared = 0.0;
+	window.fill(0.0);
+	windowPosition = 0;
+	windowEnergy = 0.0;
+	windowMax = 0.0;
+}
+/**
+ * @brief Metoda ustawiająca krzywą korekcji charakterystyki częstotliwościowej urządzenia. Obowiązuje od następnego reset().
+ * @param response Krzywa korekcji; pusty wskaźnik wyłącza korekcję.
+ */
+void LevelAnalyzer::setResponse(const QSharedPointer<const FrequencyResponse> &response)
+{
+	this->response = response;
+}
+/**
+ * @brief Metoda wybierająca metodę liczenia głośności. Wywoływana w wątku analizy przed pomiarem (po reset()), więc analizator
+ * nie odczytuje ustawienia AudioModel zmienianego w wątku interfejsu. Domyślnie FftEngine.
+ * @param engine Metoda liczenia głośności.
+ */
+void LevelAnalyzer::setEngine(AudioModel::Engine engine)
+{
+	this->engine = engine;
+}
+/**
+ * @brief Metoda ustawiająca liczbę próbek rozbiegu na początku pomiaru. Przechodzą one tylko przez filtr charakterystyki A, aby ustalił się
+ * jego stan, a miary liczone są od następnej próbki. Obowiązuje do następnego reset().
+ * @param samples Liczba próbek rozbiegu.
+ */
+void LevelAnalyzer::setLeadIn(long long samples)
+{
+	leadIn = samples;
+}
+/**
+ * @brief Metoda dodająca kolejne próbki. Każda zapełniona ramka jest od razu analizowana.
+ * @param samples Próbki sygnału (w zakresie [-1,1]).
+ * @param count Liczba próbek.
+ */
+void LevelAnalyzer::process(const Sample *samples, int count)
+{
+	if (leadIn > 0)
+	{
+		const int n = (int) std::min<long long>(count, leadIn);
+		for (int i = 0; i < n; ++i)
+			filter.process(samples[i]);
+		leadIn -= n;
+		samples += n;
+		count -= n;
+	}
+	sampleCount += count;
+	filterSamples(samples, count);
+	if (engine == AudioModel::IirEngine)
+		return;
+	while (count > 0)
+	{
+		int n = std::min(count, frameSize - filled);
+		std::copy(samples, samples + n, frame.data() + filled);
+		filled += n;
+		samples += n;
+		count -= n;
+		if (filled == frameSize)
+			analyseFrame();
+	}
+}
+/**
+ * @brief Metoda dodająca energię zgromadzonej ramki do sumy i opróżniająca ramkę.
+ */
+void LevelAnalyzer::analyseFrame()
+{
+	// The last, incomplete frame is zero-padded, so every frame uses the same cached plan and weighting table.
+	// The overload (double or fftwf) follows the Sample type; neither takes a lock.
+	spectrumEnergy += AudioModel::frameEnergy(frame.constData(), filled, transform, *weighting);
+	filled = 0;
+}
+/**
+ * @brief Metoda przepuszczająca próbki przez filtr charakterystyki A i aktualizująca w jednym przebiegu wszystkie miary
+ * liczone w dziedzinie czasu.
+ * @param samples Próbki sygnału (w zakresie [-1,1]).
+ * @param count Liczba próbek.
+ */
+void LevelAnalyzer::filterSamples(const Sample *samples, int count)
+{
+	const int windowLength = window.length();
+	double *ring = window.data();
+	for (int i = 0; i < count; ++i)
+	{
+		const double x = samples[i]; // The filter state stays in double precision also for float samples.
+		const double y = filter.process(x);
+		const double squared = y * y;
+		filteredEnergy += squared;
+		fastMax = std::max(fastMax, fastWeighting.process(squared));
+		peakSquared = std::max(peakSquared, x * x);
+		// Running sum over the last second of squared samples.
+		windowEnergy += squared - ring[windowPosition];
+		ring[windowPosition] = squared;
+		if (++windowPosition == windowLength)
+			windowPosition = 0;
+		windowMax = std::max(windowMax, windowEnergy);
+	}
+}
+/**
+ * @brief Metoda kończąca pomiar. Analizuje niepełną ostatnią ramkę i zwraca wyniki.
+ * @param calibrationData Dane kalibracyjne.
+ * @return Miary nagrania w decybelach. Leq jest taki sam jak zwracany przez AudioModel::computeLevel.
+ */
+LevelMetrics LevelAnalyzer::finish(double calibrationData)
+{
+	if (filled > 0)
+		analyseFrame();
+
+	LevelMetrics metrics;
+	double energy = engine == AudioModel::IirEngine ? filteredEnergy : spectrumEnergy;
+	metrics.leq = AudioModel::toDecibels(energy, sampleCount, calibrationData);
+	metrics.fastMax = AudioModel::toDecibels(fastMax, 1, calibrationData);
+	metrics.peak = AudioModel::toDecibels(peakSquared, 1, calibrationData);
+	// Recordings shorter than the window are treated as followed by silence.
+	metrics.loudestSecond = AudioModel::toDecibels(windowMax, window.length(), calibrationData);
+	return metrics;
+}
@@ -0,0 +1,73 @@
+#ifndef LEVELANALYZER_H
+#define LEVELANALYZER_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include "audiomodel.h"
+#include "fftplancache.h"
+#include "aweightingfilter.h"
+#include "levelmetrics.h"
+#include "sampleconsumer.h"
+#include "weightingtable.h"
+
+/**
+ * @brief Klasa obliczająca głośność strumieniowo, w trakcie nagrywania. Równoważny poziom liczony jest wybraną w AudioModel metodą:
+ * dla FFT sumowana jest energia z charakterystyką A każdej pełnej ramki (AudioModel::frameEnergy), dla filtra IIR energia próbek
+ * przefiltrowanych filtrem charakterystyki A. Ten sam, jeden przebieg filtra IIR wyznacza też pozostałe miary z LevelMetrics:
+ * maksymalny poziom Fast, poziom szczytowy i najgłośniejsze okno 1 s. Wynik jest gotowy zaraz po zakończeniu nagrywania,
+ * a zużycie pamięci zależy tylko od rozmiaru ramki i okna. Dla sygnałów stacjonarnych Leq jest zgodny z AudioModel::computeLevel
+ * liczonym dla całego nagrania. Plan FFT i tablica wag pobierane są raz, w konstruktorze, więc analizatory kilku stanowisk
+ * nie blokują się nawzajem. Krzywa korekcji urządzenia (setResponse) jest wliczona w tablicę wag, więc dotyczy Leq liczonego przez FFT.
+ * Próbki rozbiegu (setLeadIn, np. bufor wyprzedzenia rejestratora) tylko ustalają stan filtra charakterystyki A i nie wchodzą do miar.
+ */
+class LevelAnalyzer : public SampleConsumer
+{
+	QVector<Sample> frame;
+	FftPlanCache::Binding transform;
+	QSharedPointer<const WeightingTable> weighting;
+	QSharedPointer<const FrequencyResponse> response;
+	int filled;
+	double spectrumEnergy;
+	long long sampleCount;
+	long long leadIn;
+	AudioModel::Engine engine;
+
+	AWeightingFilter filter;
+	TimeWeighting fastWeighting;
+	double filteredEnergy;
+	double fastMax;
+	double peakSquared;
+	QVector<double> window;
+	int windowPosition;
+	double windowEnergy;
+	double windowMax;
+
+	void analyseFrame();
+	void filterSamples(const Sample *samples, int count);
+public:
+	/**
+	 * @brief Liczba próbek w jednej ramce (ok. 170 ms przy 48 kHz).
+	 */
+	static const int frameSize = 8192;
+
+	LevelAnalyzer();
+	void reset();
+	void setResponse(const QSharedPointer<const FrequencyResponse> &response);
+	void setLeadIn(long long samples);
+	void setEngine(AudioModel::Engine engine);
+	void process(const Sample *samples, int count);
+	/**
+	 * @brief Przyjmuje blok próbek od AudioSink; to samo co process().
+	 * @param samples Próbki sygnału (w zakresie [-1,1]).
+	 * @param count Liczba próbek.
+	 */
+	void consume(const Sample *samples, int count) override { process(samples, count); }
+	LevelMetrics finish(double calibrationData = 0.0);
+	/**
+	 * @brief Zwraca liczbę próbek uwzględnionych w miarach od ostatniego wywołania reset() (bez próbek rozbiegu).
+	 * @return Liczba próbek.
+	 */
+	long long samples() const { return sampleCount; }
+};
+
+#endif // LEVELANALYZER_H
@@ -0,0 +1,33 @@
+#include "levelmeter.h"
+
+/**
+ * @brief Konstruktor.
+ * @param parent Obiekt nadrzędny.
+ */
+LevelMeter::LevelMeter(QObject *parent) : QObject(parent), filter(AudioModel::sampleRate()),
+	weighting(TimeWeighting::fast, AudioModel::sampleRate())
+{
+}
+/**
+ * @brief Metoda zerująca stan miernika przed nowym nagraniem.
+ */
+void LevelMeter::reset()
+{
+	filter.reset();
+	weighting.reset();
+}
+/**
+ * @brief Metoda przetwarzająca blok próbek i wysyłająca poziom na jego końcu.
+ * @param samples Próbki sygnału (w zakresie [-1,1]).
+ * @param count Liczba próbek.
+ */
+void LevelMeter::consume(const Sample *samples, int count)
+{
+	double value = 0.0;
+	for (int i = 0; i < count; ++i)
+	{
+		const double y = filter.process(samples[i]);
+		value = weighting.process(y * y);
+	}
+	emit levelChanged(AudioModel::toDecibels(value, 1, 0.0));
+}
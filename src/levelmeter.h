@@ -0,0 +1,29 @@
+#ifndef LEVELMETER_H
+#define LEVELMETER_H
+
+#include <QObject>
+#include "aweightingfilter.h"
+#include "sampleconsumer.h"
+
+/**
+ * @brief Miernik bieżącego poziomu dźwięku w trakcie nagrywania: poziom z charakterystyką A i uśrednianiem Fast (LAF),
+ * odczytywany po każdym bloku próbek.
+ */
+class LevelMeter : public QObject, public SampleConsumer
+{
+	Q_OBJECT
+	AWeightingFilter filter;
+	TimeWeighting weighting;
+public:
+	explicit LevelMeter(QObject *parent = nullptr);
+	void reset();
+	void consume(const Sample *samples, int count) override;
+signals:
+	/**
+	 * @brief Sygnał z bieżącym poziomem.
+	 * @param level Poziom w decybelach (bez danych kalibracyjnych).
+	 */
+	void levelChanged(double level);
+};
+
+#endif // LEVELMETER_H
@@ -0,0 +1,51 @@
+#ifndef LEVELMETRICS_H
+#define LEVELMETRICS_H
+
+#include <QMetaType>
+
+/**
+ * @brief Wyniki jednego nagrania w decybelach (bez danych kalibracyjnych), liczone przez LevelAnalyzer w jednym przebiegu po próbkach.
+ */
+struct LevelMetrics
+{
+	/**
+	 * @brief Miara, według której układany jest ranking uczestników.
+	 */
+	enum Metric
+	{
+		Leq, /**< Równoważny poziom dźwięku z charakterystyką A z całego nagrania. */
+		FastMax, /**< Maksymalny poziom z charakterystyką A i uśrednianiem Fast, 125 ms (LAFmax). */
+		Peak, /**< Poziom szczytowy próbek bez korekcji częstotliwościowej. */
+		LoudestSecond /**< Równoważny poziom z charakterystyką A z najgłośniejszego okna o długości 1 s. */
+	};
+
+	double leq;
+	double fastMax;
+	double peak;
+	double loudestSecond;
+
+	LevelMetrics() : leq(0.0), fastMax(0.0), peak(0.0), loudestSecond(0.0) {}
+	/**
+	 * @brief Zwraca wartość wybranej miary.
+	 * @param metric Miara.
+	 * @return Poziom w decybelach.
+	 */
+	double value(Metric metric) const
+	{
+		switch (metric)
+		{
+		case FastMax:
+			return fastMax;
+		case Peak:
+			return peak;
+		case LoudestSecond:
+			return loudestSecond;
+		default:
+			return leq;
+		}
+	}
+};
+
+Q_DECLARE_METATYPE(LevelMetrics)
+
+#endif // LEVELMETRICS_H
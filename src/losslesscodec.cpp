@@ -0,0 +1,197 @@
+#include "losslesscodec.h"
+#include <QtEndian>
+
+/**
+ * @brief Największy parametr kodu Rice'a; reszty mieszczą się w 21 bitach.
+ */
+static const int maxRiceParameter = 20;
+
+/**
+ * @brief Reszta predykcji stałym predyktorem danego rzędu (jak w FLAC).
+ * @param x Wskaźnik na bieżącą próbkę; wcześniejsze próbki muszą istnieć.
+ * @param order Rząd predyktora.
+ * @return Reszta predykcji.
+ */
+static inline qint32 residual(const qint16 *x, int order)
+{
+	switch (order)
+	{
+	case 1:
+		return x[0] - x[-1];
+	case 2:
+		return x[0] - 2 * x[-1] + x[-2];
+	case 3:
+		return x[0] - 3 * x[-1] + 3 * x[-2] - x[-3];
+	case 4:
+		return x[0] - 4 * x[-1] + 6 * x[-2] - 4 * x[-3] + x[-4];
+	default:
+		return x[0];
+	}
+}
+/**
+ * @brief Odwrotność residual(): odtwarza próbkę z reszty i poprzednich próbek.
+ */
+static inline qint32 restore(qint32 r, const qint16 *x, int order)
+{
+	switch (order)
+	{
+	case 1:
+		return r + x[-1];
+	case 2:
+		return r + 2 * x[-1] - x[-2];
+	case 3:
+		return r + 3 * x[-1] - 3 * x[-2] + x[-3];
+	case 4:
+		return r + 4 * x[-1] - 6 * x[-2] + 4 * x[-3] - x[-4];
+	default:
+		return r;
+	}
+}
+/**
+ * @brief Zamiana liczby ze znakiem na liczbę bez znaku (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...).
+ */
+static inline quint32 zigzag(qint32 r)
+{
+	return ((quint32) r << 1) ^ (quint32) (r >> 31);
+}
+
+/**
+ * @brief Metoda kodująca blok próbek i dopisująca go do bufora.
+ * @param samples Próbki.
+ * @param count Liczba próbek.
+ * @param out Bufor wyjściowy.
+ */
+void LosslessCodec::encodeBlock(const qint16 *samples, int count, QByteArray &out)
+{
+	// Pick the predictor with the smallest total magnitude of residuals, then the Rice parameter for it (FLAC's estimate).
+	int order = 0;
+	quint64 best = 0;
+	for (int o = 0; o <= maxOrder && o < count; ++o)
+	{
+		quint64 sum = 0;
+		for (int i = o; i < count; ++i)
+			sum += zigzag(residual(samples + i, o));
+		if (o == 0 || sum < best)
+		{
+			best = sum;
+			order = o;
+		}
+	}
+	const int n = count - order;
+	int k = 0;
+	quint64 bits = 0;
+	for (int p = 0; p <= maxRiceParameter; ++p)
+	{
+		const quint64 estimate = (quint64) n * (p + 1) + (best >> p);
+		if (p == 0 || estimate < bits)
+		{
+			bits = estimate;
+			k = p;
+		}
+	}
+
+	out.append((char) order);
+	out.append((char) k);
+	for (int i = 0; i < order; ++i)
+	{
+		uchar bytes[2];
+		qToLittleEndian<qint16>(samples[i], bytes);
+		out.append(reinterpret_cast<const char *>(bytes), 2);
+	}
+	quint64 accumulator = 0;
+	int used = 0;
+	auto put = [&](quint32 value, int length) {
+		accumulator = (accumulator << length) | value;
+		used += length;
+		while (used >= 8)
+		{
+			used -= 8;
+			out.append((char) (accumulator >> used));
+		}
+	};
+	for (int i = order; i < count; ++i)
+	{
+		const quint32 u = zigzag(residual(samples + i, order));
+		// Quotient in unary (ones terminated by a zero), then the k low bits.
+		for (quint32 q = u >> k; q > 0; )
+		{
+			const int chunk = (int) qMin<quint32>(q, 24);
+			put((1u << chunk) - 1, chunk);
+			q -= chunk;
+		}
+		put(0, 1);
+		if (k > 0)
+			put(u & ((1u << k) - 1), k);
+	}
+	if (used > 0)
+		out.append((char) (accumulator << (8 - used)));
+}
+/**
+ * @brief Metoda dekodująca blok.
+ * @param data Zakodowany blok.
+ * @param size Rozmiar bloku w bajtach.
+ * @param samples Bufor wyjściowy.
+ * @param count Liczba próbek w bloku.
+ * @return Czy blok był poprawny.
+ */
+bool LosslessCodec::decodeBlock(const uchar *data, int size, qint16 *samples, int count)
+{
+	if (size < 2)
+		return false;
+	const int order = data[0];
+	const int k = data[1];
+	if (order > maxOrder || order > count || k > maxRiceParameter || size < 2 + 2 * order)
+		return false;
+	for (int i = 0; i < order; ++i)
+		samples[i] = qFromLittleEndian<qint16>(data + 2 + 2 * i);
+
+	const uchar *in = data + 2 + 2 * order;
+	const uchar *end = data + size;
+	quint64 accumulator = 0;
+	int available = 0;
+	for (int i = order; i < count; ++i)
+	{
+		quint32 q = 0;
+		for (;;)
+		{
+			if (available == 0)
+			{
+				if (in == end)
+					return false;
+				accumulator = *in++;
+				available = 8;
+			}
+			// Count the leading ones of the remaining bits at once.
+			const uchar bits = (uchar) (accumulator << (8 - available));
+			int ones = 0;
+			while (ones < available && (bits & (0x80 >> ones)))
+				++ones;
+			q += ones;
+			available -= ones;
+			if (available > 0)
+			{
+				--available; // The terminating zero.
+				break;
+			}
+		}
+		quint32 low = 0;
+		for (int need = k; need > 0; )
+		{
+			if (available == 0)
+			{
+				if (in == end)
+					return false;
+				accumulator = *in++;
+				available = 8;
+			}
+			const int take = qMin(need, available);
+			available -= take;
+			low = (low << take) | ((accumulator >> available) & ((1u << take) - 1));
+			need -= take;
+		}
+		const quint32 u = (q << k) | low;
+		const qint32 r = (qint32) (u >> 1) ^ -(qint32) (u & 1);
+		samples[i] = (qint16) restore(r, samples + i, order);
+	}
+	return true;
+}
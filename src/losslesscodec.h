@@ -0,0 +1,27 @@
+#ifndef LOSSLESSCODEC_H
+#define LOSSLESSCODEC_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * @brief Bezstratna kompresja bloków próbek PCM 16 bitów, podobna do FLAC: dla każdego bloku wybierany jest predyktor liniowy
+ * o stałych współczynnikach (rzędu 0-4), a reszty predykcji kodowane są kodem Rice'a z parametrem dobranym do bloku.
+ * Bloki dekodują się niezależnie, więc plik z indeksem bloków (CompressedAudioFile) pozwala odczytać dowolny fragment nagrania.
+ *
+ * Blok: rząd predyktora (1 bajt), parametr Rice'a (1 bajt), próbki początkowe (rząd * 2 bajty, little endian),
+ * a dalej strumień bitów z resztami pozostałych próbek (od najstarszego bitu, dopełniony do pełnego bajtu).
+ */
+class LosslessCodec
+{
+public:
+	/**
+	 * @brief Największy obsługiwany rząd predyktora.
+	 */
+	static const int maxOrder = 4;
+
+	static void encodeBlock(const qint16 *samples, int count, QByteArray &out);
+	static bool decodeBlock(const uchar *data, int size, qint16 *samples, int count);
+};
+
+#endif // LOSSLESSCODEC_H
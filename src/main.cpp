@@ -1,9 +1,16 @@
 #include "mainwindow.h"
 #include "userwindow.h"
+#include "benchmark.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    // kk --benchmark [plik.wav]: pomiar wydajności obliczeń bez interfejsu graficznego.
+    if (argc > 1 && QString(argv[1]) == "--benchmark")
+    {
+        QCoreApplication a(argc, argv);
+        return Benchmark::run(argc > 2 ? QString::fromLocal8Bit(argv[2]) : QString("kalibracja.wav"));
+    }
     QApplication a(argc, argv);
     UserWindow uw;
     MainWindow w(&uw);
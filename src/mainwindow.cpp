@@ -3,6 +3,8 @@
 #include "audiomodel.h"
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QActionGroup>
+#include <QInputDialog>
 /**
  * @brief Konstruktor. Tworzy okno wraz ze wszystkimi przyciskami dla osoby przeprowadzającej konkurs krzykaczy.
  * @param uw Okno z rankingiem uczestników konkursu.
@@ -18,25 +20,47 @@ MainWindow::MainWindow(UserWindow *uw, QWidget *parent) :
 	setFixedSize(size());
     //tworzymy okno userWindow
     userWindow = uw;
-    //ustawiamy zmienną określającą czy nagrywanie jest w toku na false
-    recordOnRun = false;
-    //inicjalizujemy kalibrator
-	calibrator = new Calibrator(&recorder, this);
+    //domyślnie ranking układamy według średniego poziomu
+    scoringMetric = LevelMetrics::Leq;
+    //domyślnie urządzenie wejścia uruchamiane jest dopiero po naciśnięciu "Nagrywaj"
+    preRoll = 0;
+    //domyślnie sygnał kalibracyjny nagrywany jest przez pełny czas nagrania
+    calibrationTolerance = 0.0;
+    calibrationMaxDuration = 5000;
+    //tworzymy pierwsze stanowisko (rejestrator z kalibratorem), kolejne dodaje prowadzący
+    addLane();
     //inicjalizujemy listę dostępnych urządzeń wejścia
     initialiseDeviceList();
     //łączymy przycisk "Nagrywaj" z sygnałem
     connect(ui->recordButton, SIGNAL(pressed()), this, SLOT(proceed()));
-    //łączymy combobox wyboru urządzeń z sygnałem
-	connect(ui->deviceComboBox, SIGNAL(currentTextChanged(QString)), &recorder, SLOT(InitialiseRecorder(QString)));
-    //łączymy przycisk "Kalibracja" z sygnałem
-	connect(calibrator, SIGNAL(calibrationStopped()), this, SLOT(onCalibrationStopped()));
+    //łączymy combobox wyboru urządzeń i stanowisk z sygnałami; urządzenie przypisywane jest wybranemu stanowisku
+	connect(ui->deviceComboBox, SIGNAL(currentTextChanged(QString)), this, SLOT(onDeviceSelected(QString)));
+	connect(ui->laneComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onLaneSelected(int)));
+	if (ui->deviceComboBox->count() > 0)
+		lanes.first()->SetDevice(ui->deviceComboBox->currentText());
+	updateLaneControls();
     //ustawiamy parametry listy użytkowników w mainWindow
-    ui->AdminUserList->setColumnCount(5);
-    QStringList Header;
-    Header<<"Imię"<<"Nazwisko"<<"Płeć"<<"Wynik"<<"Czy było ponowne podejście?";
-    ui->AdminUserList->setHorizontalHeaderLabels(Header);
-    ui->AdminUserList->horizontalHeader()->setStretchLastSection(true); // Resize last column to fit QTableWidget edge.
+    //tabela czyta dane wprost z listy użytkowników, komórki powstają tylko dla widocznych wierszy
+    participants = new ParticipantTableModel(this);
+    ui->AdminUserList->setModel(participants);
+    ui->AdminUserList->horizontalHeader()->setStretchLastSection(true); // Resize last column to fit QTableView edge.
+    ui->AdminUserList->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     ui->AllRadioButton->setChecked(true);
+    //metody pomiaru wykluczają się nawzajem
+    auto engineGroup = new QActionGroup(this);
+    engineGroup->addAction(ui->actionEngineFft);
+    engineGroup->addAction(ui->actionEngineIir);
+    //miary rankingu również wykluczają się nawzajem
+    auto metricGroup = new QActionGroup(this);
+    ui->actionMetricLeq->setData(LevelMetrics::Leq);
+    ui->actionMetricFastMax->setData(LevelMetrics::FastMax);
+    ui->actionMetricPeak->setData(LevelMetrics::Peak);
+    ui->actionMetricLoudestSecond->setData(LevelMetrics::LoudestSecond);
+    metricGroup->addAction(ui->actionMetricLeq);
+    metricGroup->addAction(ui->actionMetricFastMax);
+    metricGroup->addAction(ui->actionMetricPeak);
+    metricGroup->addAction(ui->actionMetricLoudestSecond);
+    connect(metricGroup, SIGNAL(triggered(QAction*)), this, SLOT(onScoringMetricTriggered(QAction*)));
 }
 /**
  * @brief Destruktor. Niszczy okno administratora.
@@ -45,7 +69,7 @@ MainWindow::MainWindow(UserWindow *uw, QWidget *parent) :
 MainWindow::~MainWindow()
 {
 	delete ui;
-	delete calibrator;
+	qDeleteAll(lanes);
 }
 /**
  * @brief Metoda wywołująca okno po zamknięciu programu. Umożliwia użytkownikowi powrót do programu bądź zapis listy użytkowników do pliku CSV.
@@ -76,46 +100,50 @@ void MainWindow::closeEvent(QCloseEvent *event)
 	}
 }
 /**
- * @brief Metoda odpowiadająca za przycisk "Nagrywaj". Uruchamia proces pobierania danych z urządzenia wejścia i przetwarzania go na głośność krzyku wyrażaną w decybelach.
+ * @brief Metoda odpowiadająca za przycisk "Nagrywaj". Uruchamia na wybranym stanowisku proces pobierania danych z urządzenia wejścia i przetwarzania go na głośność krzyku wyrażaną w decybelach,
+ * a jeśli stanowisko już nagrywa, przerywa nagranie. Pozostałe stanowiska nagrywają w tym czasie niezależnie.
  * @warning Może zostać wyłącznie wywołana, gdy wybrany jest jeden z uczestników, w przeciwnym wypadku wyświetli adekwatny błąd.
  * @authors Marcin Anuszkiewcz Sebastian Zyśk Kamil Wasilewski
  */
 void MainWindow::proceed()
 {
+    RecordingLane *lane = currentLane();
+    //jeżeli na stanowisku trwa nagrywanie, przerywamy je
+    if (lane->Participant() != 0)
+    {
+        lane->Stop();
+        return;
+    }
 
     int rowindex = ui->AdminUserList->selectionModel()->currentIndex().row();
     //sprawdzamy czy użytkownik jest zaznaczony
     try
     {    if (rowindex >= 0)
          {
+            const User user = User::GetUser(rowindex);
+            //uczestnik może krzyczeć tylko na jednym stanowisku naraz
+            for (RecordingLane *other : lanes)
+            {
+                if (other->Participant() == user.getId())
+                {
+                    QMessageBox::information(this, windowTitle(), tr("Ten użytkownik nagrywa już na stanowisku %1.").arg(other->Number()));
+                    return;
+                }
+            }
             //sprawdzamy czy użytkownik wykorzystał limit podejść
-            if (ui->AdminUserList->item(rowindex,4)->checkState() == Qt::Unchecked)
+            if (!participants->isRetried(rowindex))
             {
                 //jeżeli wynik jest różny od 0 to znaczy że jedna próba została wykorzystana
-                if (ui->AdminUserList->item(rowindex,3)->data(Qt::DisplayRole).toDouble() != 0.0)
+                if (user.getShoutScore() != 0.0)
                 {
                     //zaznaczamy checkboxa
-                    ui->AdminUserList->item(rowindex,4)->setCheckState(Qt::Checked);
-                }
-                //jeżeli nagrywanie jest w trakcie
-				if (!recordOnRun)
-                {
-                    //łączymy recorder z sygnałem
-					connect(&recorder, SIGNAL(recordingStopped(const QVector<std::complex<double> > &)), this, SLOT(onRecordingStopped(const QVector<std::complex<double> > &)));
-                    currentUser = rowindex; // onRecordingStopped() slot must know, to which user it should assigns shout level.
-                    //zaczynamy nagrywanie
-                    recorder.Start();
-                    //ustalamy zmienną kontrolną na true (nagrywanie trwa)
-                    recordOnRun = true;
-                    //Zmieniamy napis na przycisku "Nagrywaj"
-                    ui->recordButton->setText(tr("Zatrzymaj"));
-                    //Uniemożliwiamy użytkownikowi zmianę urządzenia wejścia
-                    ui->deviceComboBox->setEnabled(false);
+                    participants->setRetried(rowindex, true);
                 }
-                else
-                {
-                    recorder.Stop();
-				}
+                //zaczynamy nagrywanie, zaznaczony checkbox oznacza drugie podejście; stanowisko pamięta ID uczestnika do czasu wyniku
+                int attempt = participants->isRetried(rowindex) ? 2 : 1;
+                lane->Record(user.getId(), ArchiveWriter::attemptFileName(user.getId(), attempt));
+                //zmieniamy napis na przycisku "Nagrywaj" i blokujemy zmianę urządzenia wejścia stanowiska
+                updateLaneControls();
             }
             else
             {
@@ -134,34 +162,200 @@ void MainWindow::proceed()
 	}
 }
 /**
- * @brief Metoda wywołana po 5 sekundach od rozpoczęcia nagrywania. Przypisuje wynik do aktualnie wybranego użytkownika i wyświetla użytkownika wraz z wynikiem na oknie przeznaczonym dla publiczności.\
- * @param complexData Dane pobrane podczas nagrywania z urządzenia wejścia
+ * @brief Metoda wywołana po zakończeniu nagrania na jednym ze stanowisk (po zebraniu ustalonej liczby próbek lub przerwaniu przez użytkownika). Przypisuje wynik do uczestnika stanowiska i wyświetla użytkownika wraz z wynikiem na oknie przeznaczonym dla publiczności.\
+ * @param lane Stanowisko, na którym odbyło się nagranie.
+ * @param participant Trwałe ID uczestnika. Jeśli uczestnika nie ma już na liście (import w trakcie nagrania), wynik jest odrzucany.
+ * @param metrics Miary głośności nagrania w decybelach policzone w trakcie nagrywania (bez danych kalibracyjnych)
  * @authors Marcin Anuszkiewcz Sebastian Zyśk Kamil Wasilewski
  */
-void MainWindow::onRecordingStopped(const QVector<std::complex<double> > &complexData)
+void MainWindow::onRecordingStopped(RecordingLane *lane, ParticipantStore::Id participant, const LevelMetrics &metrics)
 {
-    qDebug() << Calibrator::calibrationData;
-    // odsyłamy nagranie do metody computeLevel w modelu matematycznym
-    double result = AudioModel::computeLevel(complexData, Calibrator::calibrationData);
-    //przypisujemy użytkownikowi wynik w dB
-	User::setShoutScore(currentUser, result);
+    qDebug() << lane->Name() << lane->CalibrationData();
+    // wynik jest już policzony w trakcie nagrywania, wybieramy miarę rankingu i dodajemy dane kalibracyjne stanowiska
+    double result = metrics.value(scoringMetric) + lane->CalibrationData();
+	if (lane == currentLane())
+		updateLaneControls();
+    //stanowisko pamięta ID uczestnika; jego wiersz mógł się zmienić, a po imporcie nowej listy uczestnika może już nie być
+	const int row = User::indexOf(participant);
+	if (row < 0)
+	{
+		QMessageBox::warning(this, windowTitle(), tr("%1: uczestnika nagrania nie ma już na liście. Wynik %2 dB został odrzucony.")
+							 .arg(lane->Name()).arg(result, 0, 'f', 1));
+		return;
+	}
+    //przypisujemy użytkownikowi wynik w dB (tabela prowadzącego odświeża tylko tę komórkę)
+	participants->setScore(row, result);
     //umieszczamy użytkownika w rankingu
-	userWindow->InsertUserToRanking(User::GetUser(currentUser), currentUser);
-	ui->AdminUserList->setItem(currentUser,3,new QTableWidgetItem(QString::number(result))); // Update shout score in adminWindow's table.
-	ui->recordButton->setText(tr("Nagrywaj"));
-	ui->deviceComboBox->setEnabled(true);
-	recordOnRun = false;
-	disconnect(&recorder, 0, this, 0); // Prevent mainWindow from receiving signals from recorder.
+	const User user = User::GetUser(row);
+	userWindow->InsertUserToRanking(user, user.getId());
+}
+/**
+ * @brief Metoda wyświetlająca bieżący poziom wybranego stanowiska na przycisku zatrzymania nagrywania.
+ * @param lane Stanowisko.
+ * @param level Poziom w decybelach (bez danych kalibracyjnych).
+ */
+void MainWindow::onLevelChanged(RecordingLane *lane, double level)
+{
+	if (lane == currentLane() && lane->Participant() != 0)
+		ui->recordButton->setText(tr("Zatrzymaj (%1 dB)").arg(level + lane->CalibrationData(), 0, 'f', 1));
 }
 /**
- * @brief Metoda kończąca kalibrację. Udostępnia możliwość kliknięcia przycisku "Nagrywaj" bądź wybrania urządzenia wejścia.
+ * @brief Metoda kończąca kalibrację stanowiska. Udostępnia możliwość kliknięcia przycisku "Nagrywaj" bądź wybrania urządzenia wejścia.
+ * @param lane Skalibrowane stanowisko.
  * @authors Marcin Anuszkiewcz Sebastian Zyśk Kamil Wasilewski
  */
-void MainWindow::onCalibrationStopped()
+void MainWindow::onCalibrationStopped(RecordingLane *lane)
 {
     //po zakończeniu kalibracji umożliwiamy użytkonikowi ponowne nagrywanie i zmianę urządzenia wejścia
-	ui->deviceComboBox->setEnabled(true);
-	ui->recordButton->setEnabled(true);
+	if (lane == currentLane())
+		updateLaneControls();
+	reportCalibration(lane);
+}
+/**
+ * @brief Metoda informująca prowadzącego o wyniku zakończonej kalibracji stanowiska: korekcji charakterystyki, odrzuceniu kalibracji
+ * bez tonu 1 kHz albo kalibracji adaptacyjnej, w której poziom się nie ustalił. Wywoływana wyłącznie po kalibracji.
+ * @param lane Skalibrowane stanowisko.
+ */
+void MainWindow::reportCalibration(RecordingLane *lane)
+{
+	const Calibrator &calibrator = lane->GetCalibrator();
+	if (calibrator.LastKind() == Calibrator::ResponseCalibration)
+	{
+		if (!calibrator.IsAccepted())
+			QMessageBox::critical(this, windowTitle(), tr("%1: nie wykryto sygnału pomiarowego w paśmie 1 kHz. Korekcja charakterystyki nie została zmieniona.")
+								  .arg(lane->Name()));
+		else
+		{
+			const QVector<float> &bands = calibrator.Response()->bands();
+			QMessageBox::information(this, windowTitle(), tr("%1: korekcja charakterystyki od %2 dB do %3 dB.").arg(lane->Name())
+									 .arg(*std::min_element(bands.begin(), bands.end()), 0, 'f', 1)
+									 .arg(*std::max_element(bands.begin(), bands.end()), 0, 'f', 1));
+		}
+		return;
+	}
+	//kalibracja bez tonu kalibracyjnego (np. z niewłaściwego urządzenia) nie zmienia danych kalibracyjnych
+	if (!calibrator.IsAccepted())
+	{
+		const ToneCheck tone = calibrator.Tone();
+		QMessageBox::critical(this, windowTitle(), tr("%1: nie wykryto sygnału kalibracyjnego 1 kHz (częstotliwość %2 Hz, czystość %3%, poziom %4 dB). "
+													  "Dane kalibracyjne nie zostały zmienione.")
+							  .arg(lane->Name()).arg(tone.frequency, 0, 'f', 0).arg(tone.purity * 100.0, 0, 'f', 0).arg(tone.level, 0, 'f', 1));
+		return;
+	}
+	//kalibracja adaptacyjna, w której poziom się nie ustalił, daje niepewne dane kalibracyjne
+	if (calibrator.Tolerance() > 0.0 && calibrator.Stability() >= 0.0 && !calibrator.IsStable())
+		QMessageBox::warning(this, windowTitle(), tr("%1: poziom sygnału kalibracyjnego nie ustalił się w ciągu %2 s (odchylenie ±%3 dB, tolerancja ±%4 dB).")
+							 .arg(lane->Name()).arg(calibrator.MeasurementTime() / 1000.0, 0, 'f', 1)
+							 .arg(calibrator.Stability(), 0, 'f', 2).arg(calibrator.Tolerance(), 0, 'f', 2));
+}
+/**
+ * @brief Metoda ostrzegająca, że ton kalibracyjny nagrany na stanowisku ma inny poziom niż przy kalibracji.
+ * @param lane Stanowisko.
+ * @param drift Różnica poziomu tonu (z danymi kalibracyjnymi) i 94 dB w decybelach.
+ */
+void MainWindow::onCalibrationDrifted(RecordingLane *lane, double drift)
+{
+	QMessageBox::warning(this, windowTitle(), tr("%1: ton kalibracyjny ma poziom %2 dB zamiast 94 dB. Skalibruj stanowisko ponownie.")
+						 .arg(lane->Name()).arg(94.0 + drift, 0, 'f', 1));
+}
+/**
+ * @brief Metoda tworząca nowe stanowisko z własnym rejestratorem, kalibracją i wątkiem analizy.
+ * @return Nowe stanowisko.
+ */
+RecordingLane *MainWindow::addLane()
+{
+	auto lane = new RecordingLane(lanes.size() + 1);
+	connect(lane, SIGNAL(recordingStopped(RecordingLane *, ParticipantStore::Id, const LevelMetrics &)), this, SLOT(onRecordingStopped(RecordingLane *, ParticipantStore::Id, const LevelMetrics &)));
+	connect(lane, SIGNAL(levelChanged(RecordingLane *, double)), this, SLOT(onLevelChanged(RecordingLane *, double)));
+	connect(lane, SIGNAL(calibrationStopped(RecordingLane *)), this, SLOT(onCalibrationStopped(RecordingLane *)));
+	connect(lane, SIGNAL(calibrationDrifted(RecordingLane *, double)), this, SLOT(onCalibrationDrifted(RecordingLane *, double)));
+	lane->GetRecorder().SetPreRoll(preRoll);
+	lane->GetCalibrator().SetAdaptive(calibrationTolerance, calibrationMaxDuration);
+	lanes.append(lane);
+	ui->laneComboBox->addItem(lane->Name());
+	return lane;
+}
+/**
+ * @brief Zwraca stanowisko wybrane w oknie prowadzącego; przycisk "Nagrywaj", kalibracja i wybór urządzenia dotyczą tego stanowiska.
+ * @return Wybrane stanowisko.
+ */
+RecordingLane *MainWindow::currentLane() const
+{
+	return lanes.value(qMax(ui->laneComboBox->currentIndex(), 0));
+}
+/**
+ * @brief Metoda dopasowująca przycisk "Nagrywaj" i wybór urządzenia do stanu wybranego stanowiska.
+ */
+void MainWindow::updateLaneControls()
+{
+	RecordingLane *lane = currentLane();
+	const bool hasDevices = ui->deviceComboBox->count() > 0;
+	ui->deviceComboBox->blockSignals(true);
+	if (!lane->Device().isEmpty())
+		ui->deviceComboBox->setCurrentText(lane->Device());
+	ui->deviceComboBox->blockSignals(false);
+	ui->deviceComboBox->setEnabled(hasDevices && !lane->IsBusy());
+	ui->recordButton->setEnabled(hasDevices && !lane->IsCalibrating());
+	ui->recordButton->setText(lane->Participant() != 0 ? tr("Zatrzymaj") : tr("Nagrywaj"));
+	//profil kalibracji urządzenia wczytywany jest przy każdej zmianie urządzenia, pokazujemy, z kiedy pochodzi
+	const Calibrator &calibrator = lane->GetCalibrator();
+	QString calibration = tr("bez kalibracji");
+	if (lane->CalibrationTime().isValid())
+	{
+		calibration = tr("kalibracja %1, %2 dB").arg(lane->CalibrationTime().toString("yyyy-MM-dd HH:mm")).arg(lane->CalibrationData(), 0, 'f', 1);
+		if (calibrator.Stability() >= 0.0)
+			calibration += tr(", ±%1 dB").arg(calibrator.Stability(), 0, 'f', 2);
+	}
+	if (!calibrator.Response().isNull())
+		calibration += tr(", z korekcją charakterystyki");
+	ui->label_2->setText(tr("Urządzenie (%1)").arg(calibration));
+}
+/**
+ * @brief Metoda wywołana po wybraniu stanowiska z listy.
+ * @param index Indeks stanowiska.
+ */
+void MainWindow::onLaneSelected(int index)
+{
+	Q_UNUSED(index);
+	updateLaneControls();
+}
+/**
+ * @brief Metoda przypisująca wybrane urządzenie wejścia do wybranego stanowiska.
+ * @param deviceName Nazwa urządzenia.
+ */
+void MainWindow::onDeviceSelected(const QString &deviceName)
+{
+	try
+	{
+		currentLane()->SetDevice(deviceName);
+	}
+	catch (exception &e)
+	{
+		QMessageBox::critical(this, windowTitle(), e.what());
+	}
+	updateLaneControls();
+}
+/**
+ * @brief Metoda odpowiedzialna za przycisk "+". Dodaje stanowisko i przypisuje mu pierwsze urządzenie wejścia, którego nie używa
+ * żadne inne stanowisko (przy kilku mikrofonach USB każde stanowisko dostaje własny).
+ */
+void MainWindow::on_addLaneButton_clicked()
+{
+	QStringList used;
+	for (RecordingLane *lane : lanes)
+		used.append(lane->Device());
+	RecordingLane *lane = addLane();
+	for (int i = 0; i < ui->deviceComboBox->count(); ++i)
+	{
+		if (!used.contains(ui->deviceComboBox->itemText(i)))
+		{
+			lane->SetDevice(ui->deviceComboBox->itemText(i));
+			break;
+		}
+	}
+	if (lane->Device().isEmpty())
+		lane->SetDevice(ui->deviceComboBox->currentText());
+	ui->laneComboBox->setCurrentIndex(lanes.size() - 1);
 }
 /**
  * @brief Metoda odpowiedzialna za możliwość wyboru urządzenia wejścia.
@@ -172,7 +366,7 @@ void MainWindow::onCalibrationStopped()
 void MainWindow::initialiseDeviceList()
 {
     //zbieramy informacje o dostępnych urządzeniach wejścia
-    auto devices = recorder.GetAvailableDevices();
+    auto devices = lanes.first()->GetRecorder().GetAvailableDevices();
     if (devices.isEmpty())
     {
         //jeżeli ich nie ma
@@ -187,32 +381,6 @@ void MainWindow::initialiseDeviceList()
         ui->deviceComboBox->addItems(devices);
     }
 }
-/**
- * @brief Metoda odpowiedzialna za dodanie nowego uczestnika konkursu do listy uczestników w oknie prowadzącego konkurs.
- * @param user Nowy użytkownik.
- * @authors Marcin Anuszkiewcz Sebastian Zyśk Kamil Wasilewski
- */
-void MainWindow::insertUserToList(User * const user)
-{
-
-    int row = ui->AdminUserList->rowCount() - 1;
-    //kolumna 0 = imie
-    ui->AdminUserList->setItem(row, 0, new QTableWidgetItem(user->getFirstName()));
-    //kolumna 1 = nazwisko
-    ui->AdminUserList->setItem(row, 1, new QTableWidgetItem(user->getLastName()));
-    QString g = user->getPersonGender() == man ? "M" : "K";
-    //kolumna 2 = płeć
-    ui->AdminUserList->setItem(row, 2, new QTableWidgetItem(g));
-    //kolumna 3 = wynik
-    ui->AdminUserList->setItem(row, 3, new QTableWidgetItem(QString::number(user->getShoutScore())));
-
-    auto *checkBoxCell = new QTableWidgetItem(); // Need to assign QTableWidgetItem's address to a pointer in order to call next two functions
-    // Do not worry about 'new' operator, QTableWidget can handle this.
-    //kolumna 4 = checkbox dot. limitu podejść
-    checkBoxCell->data(Qt::CheckStateRole);
-    checkBoxCell->setCheckState(Qt::Unchecked);
-	ui->AdminUserList->setItem(row, 4, checkBoxCell);
-}
 /**
  * @brief Metoda odpowiedzialna za działanie przycisku "Dodaj użytkownika". Uruchamia nowe okno pozwalające wpisać dane uczestnika, a następnie dodaje go do rankingu w oknie dla publiczności.
  * @authors Marcin Anuszkiewcz Sebastian Zyśk Kamil Wasilewski Dariusz Jóźko
@@ -223,12 +391,8 @@ void MainWindow::on_AddUserButton_clicked()
    auw = new AddUserWindow(this);
    if (auw->exec() == 1) // exec returns 1 when accepted.
    {
-       //przypisujemy użytkownikowi dane z okna AddUserWindow
-       User U(auw->GetName(), auw->GetSurName(), auw->GetGender(),0);
-       //zwiększamy liczbę rzędów w AdminUserList
-       ui->AdminUserList->setRowCount(ui->AdminUserList->rowCount()+1);
-       //dodajemy użytkownika do listy
-       insertUserToList(&U);
+       //dodajemy użytkownika z danymi z okna AddUserWindow do listy
+       participants->addParticipant(auw->GetName(), auw->GetSurName(), auw->GetGender());
    }
    //kasujemy okno AddUserWindow
    delete auw;
@@ -240,10 +404,6 @@ void MainWindow::on_AddUserButton_clicked()
  */
 void MainWindow::on_EditUserButton_clicked()
 {
-    QString Name;
-    QString SurName;
-    QString genderText;
-    gender g;
     //ustalamy id rzędu
     int rowidx = ui->AdminUserList->selectionModel()->currentIndex().row();
     if (rowidx < 0) // Nothing was selected.
@@ -251,29 +411,16 @@ void MainWindow::on_EditUserButton_clicked()
         QMessageBox::information(this, windowTitle(), tr("Zaznacz użytkownika, którego dane chcesz zedytować i spróbuj ponownie."));
         return;
     }
-    //przypisujemy odpowiedniemu rzędowi odpowiednie dane
-    Name = ui->AdminUserList->item(rowidx,0)->text();
-    SurName = ui->AdminUserList->item(rowidx,1)->text();
-    genderText = ui->AdminUserList->item(rowidx,2)->text();
-    g = genderText == "M" ? man : woman;
+    //do zmiennej user przypisujemy zaznaczonego użytkownika
+	auto user = User::GetUser(rowidx);
     //nowe okno AddUserWindow do edycji
-    auw = new AddUserWindow(this,Name,SurName,g);
+    auw = new AddUserWindow(this,user.getFirstName(),user.getLastName(),user.getPersonGender());
     if (auw->exec() == 1)
     {
-        if (auw->GetGender()==man)
-            genderText = "M";
-        else
-            genderText = "K";
-        //edytujemy użytkownika
-        User::editUser(rowidx,auw->GetName(),auw->GetSurName(),auw->GetGender());
-        //dodajemy go w odpowiednie miejsca w AdminWindow
-        ui->AdminUserList->setItem(rowidx,0,new QTableWidgetItem(auw->GetName()));
-        ui->AdminUserList->setItem(rowidx,1,new QTableWidgetItem(auw->GetSurName()));
-        ui->AdminUserList->setItem(rowidx,2,new QTableWidgetItem(genderText));
-        //do zmiennej user przypisujemy zaznaczonego użytkownika
-		auto user = User::GetUser(rowidx);
-        //umieszczamy go w userWindow
-		userWindow->InsertUserToRanking(user, rowidx);
+        //edytujemy użytkownika, tabela prowadzącego odświeża jego wiersz
+        participants->editParticipant(rowidx,auw->GetName(),auw->GetSurName(),auw->GetGender());
+        //umieszczamy go w userWindow z danymi po edycji
+		userWindow->InsertUserToRanking(User::GetUser(rowidx), user.getId());
     }
     delete auw;
 }
@@ -321,23 +468,15 @@ void MainWindow::on_actionImportFromCsv_triggered()
 	}
 	else
 		return;
-    //importujemy użytkowników z pliku
-	auto users = User::importFromCSV(filename);
-    //czyścimy zawartość AdminUserList
-    ui->AdminUserList->clearContents();
-    //ustawiamy obecny rząd
-    ui->AdminUserList->setRowCount(0);
+    //importujemy użytkowników z pliku; AdminUserList dostaje jeden reset zamiast wstawiania każdego rzędu
+	auto users = participants->importFromCSV(filename);
     //czyścimy zawartość userWindow
     userWindow->ClearRanking();
-    //dopisujemy każdego użytkownika do obu list
-    for (auto user : users)
+    //dopisujemy do rankingu każdego użytkownika, który krzyczał
+    for (int i = 0; i < users.size(); ++i)
     {
-        //zwiększamy licznik rzędów
-        ui->AdminUserList->setRowCount(ui->AdminUserList->rowCount() + 1);
-        insertUserToList(user);
-        //jeżeli krzyczał, przypisujemy go też do userWindow
-        if (user->getShoutScore() != 0.0)
-            userWindow->InsertUserToRanking(user, ui->AdminUserList->rowCount() - 1);
+        if (users[i].getShoutScore() != 0.0)
+            userWindow->InsertUserToRanking(users[i], users[i].getId());
     }
 }
 /**
@@ -349,12 +488,8 @@ void MainWindow::on_MenRadioButton_toggled(bool checked)
 {
 	if (checked == false)
 		return;
-    //wyswietlamy wszystkich
-    userWindow->ShowAll();
-     //ustawiamy zmienną kontrolną (m=men)
+    //wyświetlamy tylko mężczyzn (m=men)
     userWindow->SetShowing(m);
-    //ukrywamy kobiety
-    userWindow->HideWomen();
 }
 /**
  * @brief Metoda odpowiedzialna za wyświetlanie wyłącznie kobiet w oknie przeznaczonym dla publiczności.
@@ -365,12 +500,8 @@ void MainWindow::on_WomenRadioButton_toggled(bool checked)
 {
 	if (checked == false)
 		return;
-    //wyswietlamy wszystkich
-    userWindow->ShowAll();
-    //ustawiamy zmienną kontrolną (w=women)
+    //wyświetlamy tylko kobiety (w=women)
     userWindow->SetShowing(w);
-    //ukrywamy mężczyzn
-    userWindow->HideMen();
 }
 /**
  * @brief Metoda odpowiedzialna za wyświetlanie kobiet i mężczyzn w oknie przeznaczonym dla publiczności.
@@ -381,9 +512,7 @@ void MainWindow::on_AllRadioButton_toggled(bool checked)
 {
 	if (checked == false)
 		return;
-    //wyświetlamy wszystkich
-    userWindow->ShowAll();
-    //ustawiamy zmienną kontrolną (a=all)
+    //wyświetlamy wszystkich (a=all)
     userWindow->SetShowing(a);
 }
 /**
@@ -395,18 +524,24 @@ void MainWindow::on_actionCalibrate_triggered()
 {
 	QMessageBox::StandardButton reply;
     //sprawdzamy wybór użytkownika po wyświetleniu komunikatu
-	reply = QMessageBox::question(this, tr("Kalibruj"), tr("Upewnij się, że z obecnie wybranego urządzenia do nagrywania można odebrać sygnał kalibracyjny i kontynuuj."),
+	reply = QMessageBox::question(this, tr("Kalibruj"), tr("Upewnij się, że z urządzenia do nagrywania stanowiska %1 można odebrać sygnał kalibracyjny i kontynuuj.").arg(currentLane()->Number()),
 								   QMessageBox::Ok|QMessageBox::Cancel);
 	if (reply == QMessageBox::Cancel)
 	{
 	   return;
 	}
     //rozpoczynamy kalibracje
-	calibrator->Calibrate();
-    //uniemożliwiamy wybór urządzeń wejścia
-	ui->deviceComboBox->setEnabled(false);
-    //uniemozliwiamy naciśnięcie przycisku Nagrywaj
-	ui->recordButton->setEnabled(false);
+	try
+	{
+		currentLane()->Calibrate();
+	}
+	catch (exception &e)
+	{
+		QMessageBox::critical(this, windowTitle(), e.what());
+		return;
+	}
+    //uniemożliwiamy wybór urządzeń wejścia i naciśnięcie przycisku Nagrywaj na kalibrowanym stanowisku
+	updateLaneControls();
 }
 /**
  * @brief Metoda odpowiedzialna za zamknięcie wszystkich okien po kliknięciu przycisku "Zakończ".
@@ -430,6 +565,7 @@ void MainWindow::on_actionCalibrateFromFile_triggered()
     //ustalamy filtry
 	QStringList filters;
 	filters << tr("Plik WAV (*.wav)")
+			<< tr("Archiwum nagrań (*.kka)")
 			<< tr("Wszystkie pliki (*)");
 	fdialog.setNameFilters(filters);
 	if (fdialog.exec())
@@ -439,5 +575,128 @@ void MainWindow::on_actionCalibrateFromFile_triggered()
 	else
 		return;
     //wywołujemy kalibrację
-	calibrator->CalibrateFromFile(filename);
+	try
+	{
+		currentLane()->CalibrateFromFile(filename);
+		updateLaneControls();
+	}
+	catch (exception &e)
+	{
+		QMessageBox::critical(this, windowTitle(), e.what());
+	}
+}
+/**
+ * @brief Metoda wybierająca liczenie głośności przy pomocy FFT całego sygnału.
+ */
+void MainWindow::on_actionEngineFft_triggered()
+{
+	AudioModel::setEngine(AudioModel::FftEngine);
+}
+/**
+ * @brief Metoda wybierająca liczenie głośności filtrem charakterystyki A w dziedzinie czasu.
+ */
+void MainWindow::on_actionEngineIir_triggered()
+{
+	AudioModel::setEngine(AudioModel::IirEngine);
+}
+/**
+ * @brief Metoda wybierająca miarę, według której układany jest ranking. Dotyczy kolejnych nagrań.
+ * @param action Wybrana akcja z menu "Ranking według".
+ */
+void MainWindow::onScoringMetricTriggered(QAction *action)
+{
+	scoringMetric = static_cast<LevelMetrics::Metric>(action->data().toInt());
+}
+/**
+ * @brief Metoda ustawiająca długość bufora wyprzedzenia wszystkich stanowisk. Przy długości dodatniej mikrofony działają bez przerwy,
+ * więc ocena zaczyna się dokładnie w chwili naciśnięcia "Nagrywaj", a początek krzyku nie ginie w czasie uruchamiania urządzenia.
+ * Dźwięk sprzed naciśnięcia trafia tylko do archiwum.
+ */
+void MainWindow::on_actionPreRoll_triggered()
+{
+	bool ok;
+	int milliseconds = QInputDialog::getInt(this, tr("Bufor przed nagraniem"), tr("Długość dźwięku sprzed naciśnięcia \"Nagrywaj\" w ms (0 wyłącza):"),
+											preRoll, 0, Recorder::MaxPreRoll(), 100, &ok);
+	if (!ok)
+		return;
+	//bufor zmieniamy na wszystkich stanowiskach naraz, więc żadne nie może nagrywać
+	for (RecordingLane *lane : lanes)
+	{
+		if (lane->IsBusy())
+		{
+			QMessageBox::information(this, windowTitle(), tr("Poczekaj na zakończenie nagrań na wszystkich stanowiskach."));
+			return;
+		}
+	}
+	preRoll = milliseconds;
+	for (RecordingLane *lane : lanes)
+		lane->GetRecorder().SetPreRoll(preRoll);
+}
+/**
+ * @brief Metoda ustawiająca kalibrację adaptacyjną wszystkich stanowisk: tolerancję, po osiągnięciu której nagrywanie sygnału
+ * kalibracyjnego się kończy, i maksymalny czas kalibracji.
+ */
+void MainWindow::on_actionAdaptiveCalibration_triggered()
+{
+	bool ok;
+	double tolerance = QInputDialog::getDouble(this, tr("Kalibracja adaptacyjna"), tr("Dopuszczalne odchylenie poziomu sygnału kalibracyjnego w dB (0 wyłącza):"),
+											   calibrationTolerance, 0.0, 3.0, 2, &ok);
+	if (!ok)
+		return;
+	int maxDuration = calibrationMaxDuration;
+	if (tolerance > 0.0)
+	{
+		maxDuration = QInputDialog::getInt(this, tr("Kalibracja adaptacyjna"), tr("Maksymalny czas kalibracji w ms:"),
+										   calibrationMaxDuration, Calibrator::holdTime + 100, 60000, 500, &ok);
+		if (!ok)
+			return;
+	}
+	//ustawienia zmieniamy na wszystkich stanowiskach naraz, więc żadne nie może kalibrować
+	for (RecordingLane *lane : lanes)
+	{
+		if (lane->IsCalibrating())
+		{
+			QMessageBox::information(this, windowTitle(), tr("Poczekaj na zakończenie kalibracji na wszystkich stanowiskach."));
+			return;
+		}
+	}
+	calibrationTolerance = tolerance;
+	calibrationMaxDuration = maxDuration;
+	for (RecordingLane *lane : lanes)
+		lane->GetCalibrator().SetAdaptive(calibrationTolerance, calibrationMaxDuration);
+}
+/**
+ * @brief Metoda uruchamiająca kalibrację charakterystyki częstotliwościowej urządzenia wybranego stanowiska.
+ */
+void MainWindow::on_actionCalibrateResponse_triggered()
+{
+	QMessageBox::StandardButton reply;
+	reply = QMessageBox::question(this, tr("Kalibruj charakterystykę"), tr("Odtwórz przez głośnik o płaskiej charakterystyce szum różowy lub przemiatanie "
+																			"logarytmiczne 20 Hz - 20 kHz tak, aby urządzenie stanowiska %1 je odbierało, i kontynuuj.")
+								  .arg(currentLane()->Number()), QMessageBox::Ok|QMessageBox::Cancel);
+	if (reply == QMessageBox::Cancel)
+		return;
+	try
+	{
+		currentLane()->CalibrateResponse();
+	}
+	catch (exception &e)
+	{
+		QMessageBox::critical(this, windowTitle(), e.what());
+		return;
+	}
+	updateLaneControls();
+}
+/**
+ * @brief Metoda wyłączająca korekcję charakterystyki częstotliwościowej urządzenia wybranego stanowiska.
+ */
+void MainWindow::on_actionClearResponse_triggered()
+{
+	if (currentLane()->IsBusy())
+	{
+		QMessageBox::information(this, windowTitle(), tr("Poczekaj na zakończenie nagrania na stanowisku."));
+		return;
+	}
+	currentLane()->GetCalibrator().ClearResponse();
+	updateLaneControls();
 }
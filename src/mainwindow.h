@@ -3,11 +3,12 @@
 
 #include <QMainWindow>
 #include <QCloseEvent>
-#include "recorder.h"
+#include <QList>
+#include "participanttablemodel.h"
+#include "recordinglane.h"
 #include "user.h"
 #include "adduserwindow.h"
 #include "userwindow.h"
-#include "calibrator.h"
 
 namespace Ui {
 class MainWindow;
@@ -27,8 +28,13 @@ public:
 
 private slots:
     void proceed();
-	void onRecordingStopped(const QVector<std::complex<double> > &complexData);
-	void onCalibrationStopped();
+	void onRecordingStopped(RecordingLane *lane, ParticipantStore::Id participant, const LevelMetrics &metrics);
+	void onLevelChanged(RecordingLane *lane, double level);
+	void onCalibrationStopped(RecordingLane *lane);
+	void onCalibrationDrifted(RecordingLane *lane, double drift);
+	void onLaneSelected(int index);
+	void onDeviceSelected(const QString &deviceName);
+	void on_addLaneButton_clicked();
     void on_AddUserButton_clicked();
     void on_EditUserButton_clicked();
     void on_MenRadioButton_toggled(bool checked);
@@ -39,18 +45,30 @@ private slots:
 	void on_actionCalibrate_triggered();
 	void on_actionClose_triggered();
     void on_actionCalibrateFromFile_triggered();
+    void on_actionEngineFft_triggered();
+    void on_actionEngineIir_triggered();
+    void onScoringMetricTriggered(QAction *action);
+    void on_actionPreRoll_triggered();
+    void on_actionAdaptiveCalibration_triggered();
+    void on_actionCalibrateResponse_triggered();
+    void on_actionClearResponse_triggered();
 
 private:
     Ui::MainWindow *ui;
     UserWindow *userWindow;
-    bool recordOnRun;
-    Recorder recorder;
+    ParticipantTableModel *participants;
+    QList<RecordingLane *> lanes;
     AddUserWindow *auw;
-	int currentUser;
-	Calibrator *calibrator;
+	LevelMetrics::Metric scoringMetric;
+	int preRoll;
+	double calibrationTolerance;
+	int calibrationMaxDuration;
 
     void initialiseDeviceList();
-    void insertUserToList(User * const user);
+    RecordingLane *addLane();
+    RecordingLane *currentLane() const;
+    void updateLaneControls();
+    void reportCalibration(RecordingLane *lane);
 };
 
 #endif // MAINWINDOW_H
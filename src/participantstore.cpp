@@ -0,0 +1,171 @@
+#include "participantstore.h"
+#include <stdexcept>
+
+using std::logic_error;
+
+/**
+ * @brief Konstruktor. Tworzy pusty magazyn; pierwsze nadane ID to 1.
+ */
+ParticipantStore::ParticipantStore() : nextId(1)
+{
+}
+/**
+ * @brief Metoda dodająca uczestnika na końcu magazynu.
+ * @param firstName Imię.
+ * @param lastName Nazwisko.
+ * @param personGender Płeć.
+ * @param score Wynik w decybelach.
+ * @return ID nowego uczestnika.
+ */
+ParticipantStore::Id ParticipantStore::add(const QString &firstName, const QString &lastName, gender personGender, double score)
+{
+	const Id id = nextId++;
+	positions.insert(id, ids.size());
+	names.insert(Name(firstName, lastName), id);
+	ids.append(id);
+	firstNames.append(firstName);
+	lastNames.append(lastName);
+	genders.append((quint8) personGender);
+	scores.append(score);
+	return id;
+}
+/**
+ * @brief Zwraca pozycję uczestnika o podanym ID.
+ * @param id ID uczestnika.
+ * @return Pozycja (wiersz) uczestnika; -1, jeśli takiego uczestnika nie ma (np. po imporcie nowej listy).
+ */
+int ParticipantStore::indexOf(Id id) const
+{
+	return positions.value(id, -1);
+}
+/**
+ * @brief Zwraca ID uczestnika z podanej pozycji.
+ * @param index Pozycja uczestnika.
+ * @return ID uczestnika.
+ * @throw std::logic_error Jeśli pozycja jest poza zakresem.
+ */
+ParticipantStore::Id ParticipantStore::idAt(int index) const
+{
+	check(index);
+	return ids[index];
+}
+/**
+ * @brief Zwraca imię uczestnika.
+ * @param index Pozycja uczestnika.
+ * @return Imię.
+ * @throw std::logic_error Jeśli pozycja jest poza zakresem.
+ */
+const QString &ParticipantStore::firstName(int index) const
+{
+	check(index);
+	return firstNames[index];
+}
+/**
+ * @brief Zwraca nazwisko uczestnika.
+ * @param index Pozycja uczestnika.
+ * @return Nazwisko.
+ * @throw std::logic_error Jeśli pozycja jest poza zakresem.
+ */
+const QString &ParticipantStore::lastName(int index) const
+{
+	check(index);
+	return lastNames[index];
+}
+/**
+ * @brief Zwraca płeć uczestnika.
+ * @param index Pozycja uczestnika.
+ * @return Płeć.
+ * @throw std::logic_error Jeśli pozycja jest poza zakresem.
+ */
+gender ParticipantStore::personGender(int index) const
+{
+	check(index);
+	return (gender) genders[index];
+}
+/**
+ * @brief Zwraca wynik uczestnika.
+ * @param index Pozycja uczestnika.
+ * @return Wynik w decybelach.
+ * @throw std::logic_error Jeśli pozycja jest poza zakresem.
+ */
+double ParticipantStore::score(int index) const
+{
+	check(index);
+	return scores[index];
+}
+/**
+ * @brief Metoda przypisująca uczestnikowi wynik.
+ * @param index Pozycja uczestnika.
+ * @param score Wynik w decybelach.
+ * @throw std::logic_error Jeśli pozycja jest poza zakresem.
+ */
+void ParticipantStore::setScore(int index, double score)
+{
+	check(index);
+	scores[index] = score;
+}
+/**
+ * @brief Metoda zmieniająca dane uczestnika (z wyjątkiem wyniku) i aktualizująca indeks nazwisk.
+ * @param index Pozycja uczestnika.
+ * @param firstName Imię.
+ * @param lastName Nazwisko.
+ * @param personGender Płeć.
+ * @throw std::logic_error Jeśli pozycja jest poza zakresem.
+ */
+void ParticipantStore::edit(int index, const QString &firstName, const QString &lastName, gender personGender)
+{
+	check(index);
+	const Id id = ids[index];
+	names.remove(Name(firstNames[index], lastNames[index]), id);
+	names.insert(Name(firstName, lastName), id);
+	firstNames[index] = firstName;
+	lastNames[index] = lastName;
+	genders[index] = (quint8) personGender;
+}
+/**
+ * @brief Zwraca uczestników o podanym imieniu i nazwisku.
+ * @param firstName Imię.
+ * @param lastName Nazwisko.
+ * @return ID pasujących uczestników (pusta lista, jeśli nie ma żadnego).
+ */
+QList<ParticipantStore::Id> ParticipantStore::find(const QString &firstName, const QString &lastName) const
+{
+	return names.values(Name(firstName, lastName));
+}
+/**
+ * @brief Metoda rezerwująca miejsce na podaną liczbę uczestników, aby wczytanie dużej listy nie przenosiło wektorów wielokrotnie.
+ * @param count Spodziewana liczba uczestników.
+ */
+void ParticipantStore::reserve(int count)
+{
+	ids.reserve(count);
+	firstNames.reserve(count);
+	lastNames.reserve(count);
+	genders.reserve(count);
+	scores.reserve(count);
+	positions.reserve(count);
+	names.reserve(count);
+}
+/**
+ * @brief Metoda usuwająca wszystkich uczestników. Licznik ID nie jest zerowany, więc dawne ID nie wskażą nowych uczestników.
+ */
+void ParticipantStore::clear()
+{
+	ids.clear();
+	firstNames.clear();
+	lastNames.clear();
+	genders.clear();
+	scores.clear();
+	positions.clear();
+	names.clear();
+}
+/**
+ * @brief Metoda sprawdzająca pozycję uczestnika.
+ * @param index Pozycja uczestnika.
+ * @throw std::logic_error Jeśli pozycja jest mniejsza od 0 lub równa/większa od liczby uczestników.
+ */
+void ParticipantStore::check(int index) const
+{
+	if (index < 0 || index >= ids.size())
+		throw logic_error("Indeks poza zakresem listy.");
+}
@@ -0,0 +1,60 @@
+#ifndef PARTICIPANTSTORE_H
+#define PARTICIPANTSTORE_H
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+enum gender {woman,man};
+
+/**
+ * @brief Magazyn uczestników konkursu w układzie kolumnowym (struct of arrays): imiona, nazwiska, płcie i wyniki leżą w osobnych,
+ * ciągłych wektorach, a pozycja uczestnika w nich jest numerem wiersza w tabeli prowadzącego. Każdy uczestnik dostaje 64-bitowe ID,
+ * które nie zmienia się i nie jest używane ponownie (także po clear()), więc uchwyt zapamiętany przed importem listy nie wskaże
+ * innej osoby. ID i para (imię, nazwisko) są zaindeksowane tablicami mieszającymi, więc wyszukiwanie zajmuje O(1).
+ * Na uczestnika przypada stała ilość pamięci (ID, wynik, płeć, dwa wskaźniki napisów i wpisy w obu indeksach) oraz dane samych napisów.
+ */
+class ParticipantStore
+{
+public:
+	/**
+	 * @brief Trwały identyfikator uczestnika; 0 nie oznacza żadnego uczestnika.
+	 */
+	typedef quint64 Id;
+
+	ParticipantStore();
+	Id add(const QString &firstName, const QString &lastName, gender personGender, double score);
+	/**
+	 * @brief Zwraca liczbę uczestników.
+	 * @return Liczba uczestników.
+	 */
+	int size() const { return ids.size(); }
+	int indexOf(Id id) const;
+	Id idAt(int index) const;
+	const QString &firstName(int index) const;
+	const QString &lastName(int index) const;
+	gender personGender(int index) const;
+	double score(int index) const;
+	void setScore(int index, double score);
+	void edit(int index, const QString &firstName, const QString &lastName, gender personGender);
+	QList<Id> find(const QString &firstName, const QString &lastName) const;
+	void reserve(int count);
+	void clear();
+private:
+	typedef QPair<QString, QString> Name;
+
+	QVector<Id> ids;
+	QVector<QString> firstNames;
+	QVector<QString> lastNames;
+	QVector<quint8> genders;
+	QVector<double> scores;
+	QHash<Id, int> positions;
+	QMultiHash<Name, Id> names;
+	Id nextId;
+
+	void check(int index) const;
+};
+
+#endif // PARTICIPANTSTORE_H
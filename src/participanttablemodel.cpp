@@ -0,0 +1,194 @@
+#include "participanttablemodel.h"
+
+/**
+ * @brief Konstruktor. Model od razu obejmuje użytkowników znajdujących się w liście.
+ * @param parent Obiekt nadrzędny.
+ */
+ParticipantTableModel::ParticipantTableModel(QObject *parent) : QAbstractTableModel(parent), retried(User::count())
+{
+}
+/**
+ * @brief Zwraca liczbę wierszy, czyli liczbę zarejestrowanych użytkowników.
+ * @param parent Rodzic (w tabeli zawsze nieprawidłowy).
+ * @return Liczba wierszy.
+ */
+int ParticipantTableModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : User::count();
+}
+/**
+ * @brief Zwraca liczbę kolumn.
+ * @param parent Rodzic (w tabeli zawsze nieprawidłowy).
+ * @return Liczba kolumn.
+ */
+int ParticipantTableModel::columnCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : ColumnCount;
+}
+/**
+ * @brief Zwraca dane komórki, odczytane z listy użytkowników w chwili, gdy widok ich potrzebuje.
+ * @param index Komórka.
+ * @param role Rola danych.
+ * @return Imię, nazwisko, płeć ("M" albo "K") lub wynik użytkownika albo stan pola wyboru drugiego podejścia.
+ */
+QVariant ParticipantTableModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= User::count())
+		return QVariant();
+	if (index.column() == RetriedColumn)
+		return role == Qt::CheckStateRole ? QVariant(isRetried(index.row()) ? Qt::Checked : Qt::Unchecked) : QVariant();
+	if (role != Qt::DisplayRole)
+		return QVariant();
+	const User user = User::GetUser(index.row());
+	switch (index.column())
+	{
+	case FirstNameColumn:
+		return user.getFirstName();
+	case LastNameColumn:
+		return user.getLastName();
+	case GenderColumn:
+		return QString(user.getPersonGender() == man ? "M" : "K");
+	case ScoreColumn:
+		return QString::number(user.getShoutScore());
+	}
+	return QVariant();
+}
+/**
+ * @brief Zwraca nagłówki kolumn; nagłówki wierszy (numery) pochodzą z klasy bazowej.
+ * @param section Numer kolumny lub wiersza.
+ * @param orientation Orientacja nagłówka.
+ * @param role Rola danych.
+ * @return Nagłówek.
+ */
+QVariant ParticipantTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+	{
+		switch (section)
+		{
+		case FirstNameColumn:
+			return QString("Imię");
+		case LastNameColumn:
+			return QString("Nazwisko");
+		case GenderColumn:
+			return QString("Płeć");
+		case ScoreColumn:
+			return QString("Wynik");
+		case RetriedColumn:
+			return QString("Czy było ponowne podejście?");
+		}
+	}
+	return QAbstractTableModel::headerData(section, orientation, role);
+}
+/**
+ * @brief Zwraca właściwości komórki. Pole wyboru drugiego podejścia może zaznaczać prowadzący, pozostałe komórki są tylko do odczytu.
+ * @param index Komórka.
+ * @return Właściwości komórki.
+ */
+Qt::ItemFlags ParticipantTableModel::flags(const QModelIndex &index) const
+{
+	if (!index.isValid())
+		return Qt::NoItemFlags;
+	if (index.column() == RetriedColumn)
+		return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsUserCheckable;
+	return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+/**
+ * @brief Metoda zmieniająca stan pola wyboru drugiego podejścia (jedyna komórka, którą można zmienić z widoku).
+ * @param index Komórka.
+ * @param value Nowy stan pola wyboru.
+ * @param role Rola danych (tylko Qt::CheckStateRole).
+ * @return true, jeśli stan został zmieniony.
+ */
+bool ParticipantTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+	if (!index.isValid() || index.column() != RetriedColumn || role != Qt::CheckStateRole || index.row() >= User::count())
+		return false;
+	setRetried(index.row(), value.toInt() == Qt::Checked);
+	return true;
+}
+/**
+ * @brief Metoda dodająca nowego użytkownika z wynikiem 0 na końcu listy; widok dostaje wstawienie jednego wiersza.
+ * @param firstName Imię.
+ * @param lastName Nazwisko.
+ * @param personGender Płeć.
+ * @return Indeks (wiersz) nowego użytkownika.
+ */
+int ParticipantTableModel::addParticipant(const QString &firstName, const QString &lastName, gender personGender)
+{
+	const int row = User::count();
+	beginInsertRows(QModelIndex(), row, row);
+	User::addUser(firstName, lastName, personGender, 0);
+	retried.resize(row + 1);
+	endInsertRows();
+	return row;
+}
+/**
+ * @brief Metoda zmieniająca dane użytkownika (z wyjątkiem wyniku); widok dostaje zmianę jednego wiersza.
+ * @param row Indeks użytkownika.
+ * @param firstName Imię.
+ * @param lastName Nazwisko.
+ * @param personGender Płeć.
+ */
+void ParticipantTableModel::editParticipant(int row, const QString &firstName, const QString &lastName, gender personGender)
+{
+	User::editUser(row, firstName, lastName, personGender);
+	emit dataChanged(index(row, FirstNameColumn), index(row, GenderColumn));
+}
+/**
+ * @brief Metoda przypisująca użytkownikowi wynik; widok dostaje zmianę jednej komórki.
+ * @param row Indeks użytkownika.
+ * @param score Wynik w decybelach.
+ * @throw std::logic_error Jeśli indeks jest poza zakresem listy.
+ */
+void ParticipantTableModel::setScore(int row, double score)
+{
+	User::setShoutScore(row, score);
+	emit dataChanged(index(row, ScoreColumn), index(row, ScoreColumn));
+}
+/**
+ * @brief Metoda zastępująca listę użytkowników danymi z pliku CSV (zob. User::importFromCSV()). Widok dostaje jeden reset modelu
+ * zamiast wstawienia każdego wiersza osobno; znaczniki drugiego podejścia są zerowane.
+ * @param fileName Nazwa pliku z rozszerzeniem csv.
+ * @return Uchwyty wczytanych użytkowników.
+ * @throw std::logic_error Jeśli nie udało się otworzyć pliku.
+ */
+QList<User> ParticipantTableModel::importFromCSV(const QString &fileName)
+{
+	beginResetModel();
+	QList<User> users;
+	try
+	{
+		users = User::importFromCSV(fileName);
+	}
+	catch (...)
+	{
+		retried.fill(false, User::count());
+		endResetModel();
+		throw;
+	}
+	retried.fill(false, User::count());
+	endResetModel();
+	return users;
+}
+/**
+ * @brief Sprawdza, czy użytkownik wykorzystał już drugie podejście.
+ * @param row Indeks użytkownika.
+ * @return true, jeśli pole wyboru drugiego podejścia jest zaznaczone.
+ */
+bool ParticipantTableModel::isRetried(int row) const
+{
+	return row >= 0 && row < retried.size() && retried.testBit(row);
+}
+/**
+ * @brief Metoda zaznaczająca lub odznaczająca pole wyboru drugiego podejścia.
+ * @param row Indeks użytkownika.
+ * @param retried true, jeśli użytkownik wykorzystał drugie podejście.
+ */
+void ParticipantTableModel::setRetried(int row, bool retried)
+{
+	if (row < 0 || row >= this->retried.size())
+		return;
+	this->retried.setBit(row, retried);
+	emit dataChanged(index(row, RetriedColumn), index(row, RetriedColumn), QVector<int>() << Qt::CheckStateRole);
+}
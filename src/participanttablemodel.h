@@ -0,0 +1,40 @@
+#ifndef PARTICIPANTTABLEMODEL_H
+#define PARTICIPANTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QBitArray>
+#include <QList>
+#include "user.h"
+
+/**
+ * @brief Model tabeli uczestników w oknie prowadzącego. Dane czyta wprost z listy użytkowników klasy User, więc widok tworzy
+ * komórki tylko dla widocznych wierszy, a dodanie uczestnika nie alokuje żadnych elementów tabeli. Wiersz odpowiada indeksowi
+ * użytkownika w liście. Model przechowuje jedynie znacznik wykorzystania drugiego podejścia, bo lista użytkowników go nie zapisuje.
+ * Import całej listy jest zgłaszany widokowi jednym resetem modelu.
+ */
+class ParticipantTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+	QBitArray retried;
+public:
+	/**
+	 * @brief Kolumny tabeli.
+	 */
+	enum Column { FirstNameColumn, LastNameColumn, GenderColumn, ScoreColumn, RetriedColumn, ColumnCount };
+
+	explicit ParticipantTableModel(QObject *parent = nullptr);
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex &index) const override;
+	bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+	int addParticipant(const QString &firstName, const QString &lastName, gender personGender);
+	void editParticipant(int row, const QString &firstName, const QString &lastName, gender personGender);
+	void setScore(int row, double score);
+	QList<User> importFromCSV(const QString &fileName);
+	bool isRetried(int row) const;
+	void setRetried(int row, bool retried);
+};
+
+#endif // PARTICIPANTTABLEMODEL_H
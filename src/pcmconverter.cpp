@@ -0,0 +1,248 @@
+#include "pcmconverter.h"
+#include <QtEndian>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KK_X86_KERNELS
+#define KK_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+// MSVC compiles any intrinsic regardless of /arch, so the kernels need no target attribute; they only run once CPUID allows it.
+#define KK_X86_KERNELS
+#define KK_X86_MSVC
+#define KK_TARGET(isa)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Mnożnik skalujący próbkę do zakresu [-1,1].
+ */
+static const double scale = 1.0 / (double) std::numeric_limits<short>::max();
+
+template <typename T>
+static void convertScalar(const uchar *pcm, T *out, int count)
+{
+	const T s = (T) scale;
+	for (int i = 0; i < count; ++i)
+		out[i] = (T) qFromLittleEndian<qint16>(pcm + i * sizeof(qint16)) * s;
+}
+
+#ifdef KK_X86_KERNELS
+// x86 is little endian, so the samples can be loaded as they are.
+KK_TARGET("sse2")
+static void convertSse2(const uchar *pcm, float *out, int count)
+{
+	const __m128 s = _mm_set1_ps((float) scale);
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pcm + i * sizeof(qint16)));
+		// Sign-extend by placing each sample in the upper half of a 32-bit lane and shifting it down.
+		const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), s));
+		_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), s));
+	}
+	convertScalar(pcm + i * sizeof(qint16), out + i, count - i);
+}
+
+KK_TARGET("sse2")
+static void convertSse2(const uchar *pcm, double *out, int count)
+{
+	const __m128d s = _mm_set1_pd(scale);
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pcm + i * sizeof(qint16)));
+		const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+		_mm_storeu_pd(out + i, _mm_mul_pd(_mm_cvtepi32_pd(lo), s));
+		_mm_storeu_pd(out + i + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(lo, 8)), s));
+		_mm_storeu_pd(out + i + 4, _mm_mul_pd(_mm_cvtepi32_pd(hi), s));
+		_mm_storeu_pd(out + i + 6, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(hi, 8)), s));
+	}
+	convertScalar(pcm + i * sizeof(qint16), out + i, count - i);
+}
+
+KK_TARGET("avx2")
+static void convertAvx2(const uchar *pcm, float *out, int count)
+{
+	const __m256 s = _mm256_set1_ps((float) scale);
+	int i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pcm + i * sizeof(qint16)));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pcm + (i + 8) * sizeof(qint16)));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a)), s));
+		_mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(b)), s));
+	}
+	convertScalar(pcm + i * sizeof(qint16), out + i, count - i);
+}
+
+KK_TARGET("avx2")
+static void convertAvx2(const uchar *pcm, double *out, int count)
+{
+	const __m256d s = _mm256_set1_pd(scale);
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pcm + i * sizeof(qint16)));
+		const __m256i wide = _mm256_cvtepi16_epi32(x);
+		_mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(wide)), s));
+		_mm256_storeu_pd(out + i + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(wide, 1)), s));
+	}
+	convertScalar(pcm + i * sizeof(qint16), out + i, count - i);
+}
+#endif
+
+#ifdef KK_X86_MSVC
+/**
+ * @brief Sprawdza instrukcją CPUID, czy procesor obsługuje dany wariant; dla AVX2 także (XGETBV), czy system zapisuje rejestry YMM.
+ * @param kernel Wariant Sse2 lub Avx2.
+ * @return Czy wariant może być użyty.
+ */
+static bool cpuSupports(PcmConverter::Kernel kernel)
+{
+	int info[4];
+	__cpuidex(info, 0, 0);
+	const int maxLeaf = info[0];
+	__cpuidex(info, 1, 0);
+	if (kernel == PcmConverter::Sse2)
+	{
+#ifdef _M_X64
+		// SSE2 is part of the x64 baseline.
+		return true;
+#else
+		return (info[3] & (1 << 26)) != 0;
+#endif
+	}
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6 || maxLeaf < 7)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+}
+#endif
+
+/**
+ * @brief Sprawdza, czy procesor obsługuje dany wariant.
+ * @param kernel Wariant implementacji.
+ * @return Czy wariant może być użyty.
+ */
+bool PcmConverter::isSupported(Kernel kernel)
+{
+#if defined(KK_X86_KERNELS) && !defined(KK_X86_MSVC)
+	__builtin_cpu_init();
+#endif
+	switch (kernel)
+	{
+#ifdef KK_X86_MSVC
+	case Sse2:
+	case Avx2:
+		return cpuSupports(kernel);
+#elif defined(KK_X86_KERNELS)
+	case Sse2:
+		return __builtin_cpu_supports("sse2");
+	case Avx2:
+		return __builtin_cpu_supports("avx2");
+#endif
+	case Scalar:
+		return true;
+	default:
+		return false;
+	}
+}
+/**
+ * @brief Zwraca najszybszy wariant obsługiwany przez procesor. Wynik jest wyznaczany raz.
+ * @return Wariant implementacji.
+ */
+PcmConverter::Kernel PcmConverter::best()
+{
+	static const Kernel kernel = isSupported(Avx2) ? Avx2 : isSupported(Sse2) ? Sse2 : Scalar;
+	return kernel;
+}
+/**
+ * @brief Zwraca nazwę wariantu.
+ * @param kernel Wariant implementacji.
+ * @return Nazwa, np. "AVX2".
+ */
+const char *PcmConverter::name(Kernel kernel)
+{
+	switch (kernel)
+	{
+	case Sse2:
+		return "SSE2";
+	case Avx2:
+		return "AVX2";
+	default:
+		return "scalar";
+	}
+}
+/**
+ * @brief Zamienia próbki PCM na próbki typu float najszybszym obsługiwanym wariantem.
+ * @param pcm Próbki PCM, 16 bitów, little endian (bez wymagań co do wyrównania).
+ * @param out Bufor wyjściowy na count próbek.
+ * @param count Liczba próbek.
+ */
+void PcmConverter::convert(const uchar *pcm, float *out, int count)
+{
+	convert(pcm, out, count, best());
+}
+/**
+ * @brief Zamienia próbki PCM na próbki typu double najszybszym obsługiwanym wariantem.
+ * @param pcm Próbki PCM, 16 bitów, little endian (bez wymagań co do wyrównania).
+ * @param out Bufor wyjściowy na count próbek.
+ * @param count Liczba próbek.
+ */
+void PcmConverter::convert(const uchar *pcm, double *out, int count)
+{
+	convert(pcm, out, count, best());
+}
+/**
+ * @brief Zamienia próbki PCM na próbki typu float wybranym wariantem, który musi być obsługiwany (isSupported).
+ * @param pcm Próbki PCM, 16 bitów, little endian.
+ * @param out Bufor wyjściowy na count próbek.
+ * @param count Liczba próbek.
+ * @param kernel Wariant implementacji.
+ */
+void PcmConverter::convert(const uchar *pcm, float *out, int count, Kernel kernel)
+{
+	switch (kernel)
+	{
+#ifdef KK_X86_KERNELS
+	case Sse2:
+		convertSse2(pcm, out, count);
+		break;
+	case Avx2:
+		convertAvx2(pcm, out, count);
+		break;
+#endif
+	default:
+		convertScalar(pcm, out, count);
+	}
+}
+/**
+ * @brief Zamienia próbki PCM na próbki typu double wybranym wariantem, który musi być obsługiwany (isSupported).
+ * @param pcm Próbki PCM, 16 bitów, little endian.
+ * @param out Bufor wyjściowy na count próbek.
+ * @param count Liczba próbek.
+ * @param kernel Wariant implementacji.
+ */
+void PcmConverter::convert(const uchar *pcm, double *out, int count, Kernel kernel)
+{
+	switch (kernel)
+	{
+#ifdef KK_X86_KERNELS
+	case Sse2:
+		convertSse2(pcm, out, count);
+		break;
+	case Avx2:
+		convertAvx2(pcm, out, count);
+		break;
+#endif
+	default:
+		convertScalar(pcm, out, count);
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef PCMCONVERTER_H
+#define PCMCONVERTER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Zamiana próbek PCM (16 bitów, little endian) na próbki zmiennoprzecinkowe w zakresie [-1,1], całymi blokami
+ * do przygotowanego wcześniej bufora. Na procesorach x86 używa instrukcji AVX2 lub SSE2, wybieranych przy pierwszym użyciu
+ * na podstawie możliwości procesora; w pozostałych przypadkach wersji skalarnej.
+ */
+class PcmConverter
+{
+public:
+	/**
+	 * @brief Wariant implementacji.
+	 */
+	enum Kernel
+	{
+		Scalar, /**< Pętla skalarna, działa wszędzie. */
+		Sse2, /**< 8 próbek na iterację (SSE2). */
+		Avx2 /**< 16 próbek na iterację (AVX2). */
+	};
+
+	static void convert(const uchar *pcm, float *out, int count);
+	static void convert(const uchar *pcm, double *out, int count);
+	static void convert(const uchar *pcm, float *out, int count, Kernel kernel);
+	static void convert(const uchar *pcm, double *out, int count, Kernel kernel);
+	static bool isSupported(Kernel kernel);
+	static Kernel best();
+	static const char *name(Kernel kernel);
+};
+
+#endif // PCMCONVERTER_H
@@ -0,0 +1,191 @@
+#include "rankingindex.h"
+
+/**
+ * @brief Konstruktor. Tworzy pusty indeks.
+ */
+RankingIndex::RankingIndex() : root(-1), seed(2463534242u)
+{
+}
+/**
+ * @brief Metoda wstawiająca klucz do indeksu. Klucz nie może już w nim być.
+ * @param key Klucz uczestnika.
+ * @return Miejsce klucza w rankingu (od 0).
+ */
+int RankingIndex::insert(const Key &key)
+{
+	const int node = allocate(key);
+	int left, right;
+	split(root, key, left, right);
+	const int position = sizeOf(left);
+	root = merge(merge(left, node), right);
+	return position;
+}
+/**
+ * @brief Metoda usuwająca klucz z indeksu.
+ * @param key Klucz uczestnika (z wynikiem, z którym został wstawiony).
+ * @return Miejsce, które klucz zajmował (od 0); -1, jeśli klucza nie było w indeksie.
+ */
+int RankingIndex::remove(const Key &key)
+{
+	const int position = rank(key);
+	bool found = false;
+	root = erase(root, key, found);
+	return found ? position : -1;
+}
+/**
+ * @brief Zwraca miejsce, które zająłby klucz, czyli liczbę kluczy stojących przed nim.
+ * @param key Klucz uczestnika (nie musi być w indeksie).
+ * @return Miejsce w rankingu (od 0).
+ */
+int RankingIndex::rank(const Key &key) const
+{
+	int position = 0;
+	int node = root;
+	while (node >= 0)
+	{
+		if (before(nodes[node].key, key))
+		{
+			position += sizeOf(nodes[node].left) + 1;
+			node = nodes[node].right;
+		}
+		else
+			node = nodes[node].left;
+	}
+	return position;
+}
+/**
+ * @brief Zwraca uczestnika z danego miejsca rankingu.
+ * @param rank Miejsce w rankingu (od 0 do size() - 1).
+ * @return ID uczestnika; 0, jeśli miejsce jest poza rankingiem.
+ */
+ParticipantStore::Id RankingIndex::at(int rank) const
+{
+	int node = root;
+	while (node >= 0)
+	{
+		const int leftSize = sizeOf(nodes[node].left);
+		if (rank < leftSize)
+			node = nodes[node].left;
+		else if (rank == leftSize)
+			return nodes[node].key.id;
+		else
+		{
+			rank -= leftSize + 1;
+			node = nodes[node].right;
+		}
+	}
+	return 0;
+}
+/**
+ * @brief Metoda usuwająca wszystkie klucze.
+ */
+void RankingIndex::clear()
+{
+	nodes.clear();
+	freeNodes.clear();
+	root = -1;
+}
+/**
+ * @brief Metoda tworząca węzeł z losowym priorytetem (xorshift32), w miarę możliwości w miejscu zwolnionego węzła.
+ * @param key Klucz węzła.
+ * @return Indeks węzła.
+ */
+int RankingIndex::allocate(const Key &key)
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	const Node node = {key, seed, -1, -1, 1};
+	if (!freeNodes.isEmpty())
+	{
+		const int index = freeNodes.takeLast();
+		nodes[index] = node;
+		return index;
+	}
+	nodes.append(node);
+	return nodes.size() - 1;
+}
+/**
+ * @brief Metoda przeliczająca rozmiar poddrzewa węzła.
+ * @param node Indeks węzła.
+ */
+void RankingIndex::update(int node)
+{
+	nodes[node].size = sizeOf(nodes[node].left) + sizeOf(nodes[node].right) + 1;
+}
+/**
+ * @brief Metoda dzieląca poddrzewo na klucze stojące przed podanym kluczem i pozostałe.
+ * @param node Korzeń dzielonego poddrzewa.
+ * @param key Klucz podziału.
+ * @param left Korzeń poddrzewa kluczy stojących przed key.
+ * @param right Korzeń poddrzewa pozostałych kluczy.
+ */
+void RankingIndex::split(int node, const Key &key, int &left, int &right)
+{
+	if (node < 0)
+	{
+		left = right = -1;
+		return;
+	}
+	if (before(nodes[node].key, key))
+	{
+		int rest;
+		split(nodes[node].right, key, rest, right);
+		nodes[node].right = rest;
+		left = node;
+	}
+	else
+	{
+		int rest;
+		split(nodes[node].left, key, left, rest);
+		nodes[node].left = rest;
+		right = node;
+	}
+	update(node);
+}
+/**
+ * @brief Metoda łącząca dwa poddrzewa, z których pierwsze zawiera wyłącznie klucze stojące przed kluczami drugiego.
+ * @param left Korzeń pierwszego poddrzewa.
+ * @param right Korzeń drugiego poddrzewa.
+ * @return Korzeń połączonego poddrzewa.
+ */
+int RankingIndex::merge(int left, int right)
+{
+	if (left < 0)
+		return right;
+	if (right < 0)
+		return left;
+	if (nodes[left].priority > nodes[right].priority)
+	{
+		nodes[left].right = merge(nodes[left].right, right);
+		update(left);
+		return left;
+	}
+	nodes[right].left = merge(left, nodes[right].left);
+	update(right);
+	return right;
+}
+/**
+ * @brief Metoda usuwająca klucz z poddrzewa.
+ * @param node Korzeń poddrzewa.
+ * @param key Usuwany klucz.
+ * @param found Ustawiane na true, jeśli klucz został znaleziony.
+ * @return Nowy korzeń poddrzewa.
+ */
+int RankingIndex::erase(int node, const Key &key, bool &found)
+{
+	if (node < 0)
+		return node;
+	if (!before(nodes[node].key, key) && !before(key, nodes[node].key))
+	{
+		found = true;
+		freeNodes.append(node);
+		return merge(nodes[node].left, nodes[node].right);
+	}
+	if (before(key, nodes[node].key))
+		nodes[node].left = erase(nodes[node].left, key, found);
+	else
+		nodes[node].right = erase(nodes[node].right, key, found);
+	update(node);
+	return node;
+}
@@ -0,0 +1,63 @@
+#ifndef RANKINGINDEX_H
+#define RANKINGINDEX_H
+
+#include <QVector>
+#include "participantstore.h"
+
+/**
+ * @brief Indeks kolejności rankingu: drzewo pozycyjne (treap z rozmiarami poddrzew) uporządkowane malejąco według wyniku,
+ * a przy równych wynikach rosnąco według ID. Wstawienie, usunięcie, wyznaczenie miejsca klucza i odczyt uczestnika
+ * z danego miejsca zajmują O(log n). Węzły leżą w jednym wektorze i są indeksowane liczbami, a zwolnione węzły są używane ponownie.
+ */
+class RankingIndex
+{
+public:
+	/**
+	 * @brief Klucz uczestnika w rankingu.
+	 */
+	struct Key
+	{
+		double score; /**< Wynik w decybelach; NaN należy zastąpić przez -inf przed wstawieniem. */
+		ParticipantStore::Id id; /**< Trwałe ID uczestnika (ParticipantStore::Id). */
+	};
+
+	RankingIndex();
+	int insert(const Key &key);
+	int remove(const Key &key);
+	int rank(const Key &key) const;
+	ParticipantStore::Id at(int rank) const;
+	/**
+	 * @brief Zwraca liczbę uczestników w indeksie.
+	 * @return Liczba kluczy.
+	 */
+	int size() const { return root < 0 ? 0 : nodes[root].size; }
+	void clear();
+	/**
+	 * @brief Sprawdza, czy klucz a stoi w rankingu przed kluczem b.
+	 * @param a Pierwszy klucz.
+	 * @param b Drugi klucz.
+	 * @return true, jeśli a ma wyższy wynik albo równy wynik i mniejsze ID.
+	 */
+	static bool before(const Key &a, const Key &b) { return a.score > b.score || (a.score == b.score && a.id < b.id); }
+private:
+	struct Node
+	{
+		Key key;
+		unsigned priority;
+		int left, right;
+		int size;
+	};
+	QVector<Node> nodes;
+	QVector<int> freeNodes;
+	int root;
+	unsigned seed;
+
+	int allocate(const Key &key);
+	int sizeOf(int node) const { return node < 0 ? 0 : nodes[node].size; }
+	void update(int node);
+	void split(int node, const Key &key, int &left, int &right);
+	int merge(int left, int right);
+	int erase(int node, const Key &key, bool &found);
+};
+
+#endif // RANKINGINDEX_H
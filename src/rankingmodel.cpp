@@ -0,0 +1,269 @@
+#include "rankingmodel.h"
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Konstruktor. Tworzy pusty ranking wyświetlający wszystkich uczestników.
+ * @param parent Obiekt nadrzędny.
+ */
+RankingModel::RankingModel(QObject *parent) : QAbstractTableModel(parent), filter(RankingCategory::all())
+{
+}
+/**
+ * @brief Zwraca klucz uczestnika w indeksie. Wynik NaN (np. z uszkodzonego pliku) trafia na koniec rankingu.
+ * @param id ID uczestnika.
+ * @param score Wynik w decybelach.
+ * @return Klucz indeksu.
+ */
+RankingIndex::Key RankingModel::keyOf(ParticipantStore::Id id, double score)
+{
+	const RankingIndex::Key key = {std::isnan(score) ? -std::numeric_limits<double>::infinity() : score, id};
+	return key;
+}
+/**
+ * @brief Zwraca kategorie, do których należy uczestnik. Grupa wiekowa i seria są pomijane, jeśli nie zostały podane.
+ * @param entry Dane uczestnika.
+ * @return Kategorie uczestnika (od 2 do 4).
+ */
+QVector<RankingCategory> RankingModel::categoriesOf(const Entry &entry)
+{
+	QVector<RankingCategory> categories;
+	categories << RankingCategory::all() << RankingCategory::ofGender(entry.personGender);
+	if (entry.ageGroup >= 0)
+		categories << RankingCategory::ofAgeGroup(entry.ageGroup);
+	if (entry.heat >= 0)
+		categories << RankingCategory::ofHeat(entry.heat);
+	return categories;
+}
+/**
+ * @brief Zwraca indeks wyświetlanej kategorii.
+ * @return Indeks wyświetlanych uczestników; pusty, jeśli w kategorii nie ma jeszcze nikogo.
+ */
+const RankingIndex &RankingModel::shown() const
+{
+	const auto ranking = rankings.constFind(filter);
+	return ranking == rankings.constEnd() ? empty : *ranking;
+}
+/**
+ * @brief Metoda wstawiająca klucz do indeksu kategorii (tworząc indeks, jeśli go nie było); jeśli kategoria jest wyświetlana,
+ * zgłasza widokowi wstawienie jednego wiersza.
+ * @param category Kategoria.
+ * @param key Klucz uczestnika.
+ */
+void RankingModel::insertKey(const RankingCategory &category, const RankingIndex::Key &key)
+{
+	RankingIndex &ranking = rankings[category];
+	if (category != filter)
+	{
+		ranking.insert(key);
+		return;
+	}
+	const int row = ranking.rank(key);
+	beginInsertRows(QModelIndex(), row, row);
+	ranking.insert(key);
+	endInsertRows();
+}
+/**
+ * @brief Metoda usuwająca klucz z indeksu kategorii; jeśli kategoria jest wyświetlana, zgłasza widokowi usunięcie jednego wiersza.
+ * Pusty indeks niewyświetlanej kategorii jest zwalniany.
+ * @param category Kategoria.
+ * @param key Klucz uczestnika.
+ */
+void RankingModel::removeKey(const RankingCategory &category, const RankingIndex::Key &key)
+{
+	const auto ranking = rankings.find(category);
+	if (ranking == rankings.end())
+		return;
+	if (category != filter)
+	{
+		ranking->remove(key);
+		if (ranking->size() == 0)
+			rankings.erase(ranking);
+		return;
+	}
+	const int row = ranking->rank(key);
+	beginRemoveRows(QModelIndex(), row, row);
+	ranking->remove(key);
+	endRemoveRows();
+}
+/**
+ * @brief Metoda zmieniająca klucz uczestnika w indeksie kategorii. Jeśli kategoria jest wyświetlana, widok dostaje przeniesienie
+ * wiersza (gdy zmieniło się miejsce) i zmianę danych tego jednego wiersza.
+ * @param category Kategoria.
+ * @param from Dotychczasowy klucz uczestnika.
+ * @param to Nowy klucz uczestnika.
+ */
+void RankingModel::moveKey(const RankingCategory &category, const RankingIndex::Key &from, const RankingIndex::Key &to)
+{
+	RankingIndex &ranking = rankings[category];
+	if (category != filter)
+	{
+		ranking.remove(from);
+		ranking.insert(to);
+		return;
+	}
+	const int source = ranking.rank(from);
+	// The new position is counted without the old key, which stands before it when the score dropped.
+	const int destination = ranking.rank(to) - (RankingIndex::before(from, to) ? 1 : 0);
+	if (source != destination)
+		beginMoveRows(QModelIndex(), source, source, QModelIndex(), destination > source ? destination + 1 : destination);
+	ranking.remove(from);
+	ranking.insert(to);
+	if (source != destination)
+		endMoveRows();
+	emit dataChanged(index(destination, 0), index(destination, ColumnCount - 1));
+}
+/**
+ * @brief Zwraca liczbę wierszy, czyli liczbę wyświetlanych uczestników.
+ * @param parent Rodzic (w tabeli zawsze nieprawidłowy).
+ * @return Liczba wierszy.
+ */
+int RankingModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : shown().size();
+}
+/**
+ * @brief Zwraca liczbę kolumn.
+ * @param parent Rodzic (w tabeli zawsze nieprawidłowy).
+ * @return Liczba kolumn.
+ */
+int RankingModel::columnCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : ColumnCount;
+}
+/**
+ * @brief Zwraca dane komórki. Uczestnik wiersza jest odczytywany z indeksu w czasie O(log n), więc widok pyta tylko o widoczne wiersze.
+ * @param index Komórka.
+ * @param role Rola danych.
+ * @return Imię, nazwisko albo wynik uczestnika; pusta wartość dla innych ról.
+ */
+QVariant RankingModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || role != Qt::DisplayRole)
+		return QVariant();
+	const auto entry = entries.constFind(shown().at(index.row()));
+	if (entry == entries.constEnd())
+		return QVariant();
+	switch (index.column())
+	{
+	case FirstNameColumn:
+		return entry->firstName;
+	case LastNameColumn:
+		return entry->lastName;
+	case ScoreColumn:
+		return QVariant(entry->score);
+	}
+	return QVariant();
+}
+/**
+ * @brief Zwraca nagłówki kolumn; nagłówki wierszy (numery miejsc) pochodzą z klasy bazowej.
+ * @param section Numer kolumny lub wiersza.
+ * @param orientation Orientacja nagłówka.
+ * @param role Rola danych.
+ * @return Nagłówek.
+ */
+QVariant RankingModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+	{
+		switch (section)
+		{
+		case FirstNameColumn:
+			return QString("Imię");
+		case LastNameColumn:
+			return QString("Nazwisko");
+		case ScoreColumn:
+			return QString("Wynik [dB]");
+		}
+	}
+	return QAbstractTableModel::headerData(section, orientation, role);
+}
+/**
+ * @brief Metoda dodająca uczestnika do rankingu albo zmieniająca dane uczestnika, który już w nim jest. Aktualizowane są tylko
+ * indeksy kategorii, do których uczestnik należał lub należy.
+ * @param id ID uczestnika.
+ * @param firstName Imię.
+ * @param lastName Nazwisko.
+ * @param personGender Płeć.
+ * @param score Wynik w decybelach.
+ * @param ageGroup Numer grupy wiekowej; -1, jeśli uczestnik nie jest przypisany do żadnej.
+ * @param heat Numer serii; -1, jeśli uczestnik nie jest przypisany do żadnej.
+ */
+void RankingModel::setParticipant(ParticipantStore::Id id, const QString &firstName, const QString &lastName, gender personGender, double score,
+	int ageGroup, int heat)
+{
+	const RankingIndex::Key key = keyOf(id, score);
+	const Entry entry = {firstName, lastName, score, personGender, ageGroup, heat};
+	const QVector<RankingCategory> categories = categoriesOf(entry);
+	const auto existing = entries.find(id);
+	if (existing == entries.end())
+	{
+		entries.insert(id, entry);
+		for (const RankingCategory &category : categories)
+			insertKey(category, key);
+		return;
+	}
+	const RankingIndex::Key previous = keyOf(id, existing->score);
+	const QVector<RankingCategory> previousCategories = categoriesOf(*existing);
+	*existing = entry;
+	for (const RankingCategory &category : previousCategories)
+	{
+		if (categories.contains(category))
+			moveKey(category, previous, key);
+		else
+			removeKey(category, previous);
+	}
+	for (const RankingCategory &category : categories)
+	{
+		if (!previousCategories.contains(category))
+			insertKey(category, key);
+	}
+}
+/**
+ * @brief Metoda usuwająca wszystkich uczestników z rankingu.
+ */
+void RankingModel::clear()
+{
+	beginResetModel();
+	entries.clear();
+	rankings.clear();
+	endResetModel();
+}
+/**
+ * @brief Metoda wybierająca wyświetlaną kategorię. Indeks kategorii jest już uporządkowany, więc widok dostaje reset modelu
+ * i odczytuje tylko widoczne wiersze.
+ * @param filter Kategoria rankingu.
+ */
+void RankingModel::setFilter(const RankingCategory &filter)
+{
+	if (this->filter == filter)
+		return;
+	beginResetModel();
+	const auto previous = rankings.find(this->filter);
+	if (previous != rankings.end() && previous->size() == 0)
+		rankings.erase(previous);
+	this->filter = filter;
+	endResetModel();
+}
+/**
+ * @brief Zwraca liczbę uczestników w kategorii.
+ * @param category Kategoria rankingu.
+ * @return Liczba uczestników.
+ */
+int RankingModel::categorySize(const RankingCategory &category) const
+{
+	const auto ranking = rankings.constFind(category);
+	return ranking == rankings.constEnd() ? 0 : ranking->size();
+}
+/**
+ * @brief Zwraca miejsce uczestnika w wyświetlanej kategorii.
+ * @param id ID uczestnika.
+ * @return Numer wiersza (od 0); -1, jeśli uczestnika nie ma w rankingu albo nie należy do wyświetlanej kategorii.
+ */
+int RankingModel::rankOf(ParticipantStore::Id id) const
+{
+	const auto entry = entries.constFind(id);
+	if (entry == entries.constEnd() || !categoriesOf(*entry).contains(filter))
+		return -1;
+	return shown().rank(keyOf(id, entry->score));
+}
@@ -0,0 +1,88 @@
+#ifndef RANKINGMODEL_H
+#define RANKINGMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QVector>
+#include "rankingindex.h"
+#include "user.h"
+
+/**
+ * @brief Kategoria rankingu: wszyscy uczestnicy, jedna płeć, jedna grupa wiekowa albo jedna seria (eliminacje, finał itp.).
+ */
+struct RankingCategory
+{
+	/**
+	 * @brief Rodzaj kategorii.
+	 */
+	enum Kind { All, Gender, AgeGroup, Heat };
+	Kind kind; /**< Rodzaj kategorii. */
+	int value; /**< Płeć, numer grupy wiekowej albo numer serii; dla All zawsze 0. */
+
+	static RankingCategory all() { return RankingCategory{All, 0}; }
+	static RankingCategory ofGender(gender personGender) { return RankingCategory{Gender, personGender}; }
+	static RankingCategory ofAgeGroup(int ageGroup) { return RankingCategory{AgeGroup, ageGroup}; }
+	static RankingCategory ofHeat(int heat) { return RankingCategory{Heat, heat}; }
+	bool operator==(const RankingCategory &other) const { return kind == other.kind && value == other.value; }
+	bool operator!=(const RankingCategory &other) const { return !(*this == other); }
+};
+
+inline uint qHash(const RankingCategory &category, uint seed = 0)
+{
+	return qHash(((quint64) category.kind << 32) | (quint32) category.value, seed);
+}
+
+/**
+ * @brief Model rankingu wyświetlanego publiczności. Każda kategoria, do której należy choć jeden uczestnik, ma własny indeks
+ * RankingIndex, aktualizowany przyrostowo: zmiana wyniku dotyka tylko indeksów kategorii uczestnika i kosztuje O(log n) w każdym
+ * z nich, a widok dostaje tylko sygnał wstawienia, przeniesienia lub zmiany jednego wiersza. Wybór wyświetlanej kategorii
+ * podmienia indeks i resetuje model, więc widok odczytuje ponownie tylko widoczne wiersze.
+ */
+class RankingModel : public QAbstractTableModel
+{
+	Q_OBJECT
+	struct Entry
+	{
+		QString firstName;
+		QString lastName;
+		double score;
+		gender personGender;
+		int ageGroup;
+		int heat;
+	};
+	QHash<ParticipantStore::Id, Entry> entries;
+	QHash<RankingCategory, RankingIndex> rankings;
+	RankingIndex empty;
+	RankingCategory filter;
+
+	static RankingIndex::Key keyOf(ParticipantStore::Id id, double score);
+	static QVector<RankingCategory> categoriesOf(const Entry &entry);
+	const RankingIndex &shown() const;
+	void insertKey(const RankingCategory &category, const RankingIndex::Key &key);
+	void removeKey(const RankingCategory &category, const RankingIndex::Key &key);
+	void moveKey(const RankingCategory &category, const RankingIndex::Key &from, const RankingIndex::Key &to);
+public:
+	/**
+	 * @brief Kolumny rankingu.
+	 */
+	enum Column { FirstNameColumn, LastNameColumn, ScoreColumn, ColumnCount };
+
+	explicit RankingModel(QObject *parent = nullptr);
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+	void setParticipant(ParticipantStore::Id id, const QString &firstName, const QString &lastName, gender personGender, double score,
+		int ageGroup = -1, int heat = -1);
+	void clear();
+	void setFilter(const RankingCategory &filter);
+	/**
+	 * @brief Zwraca wyświetlaną kategorię.
+	 * @return Kategoria rankingu.
+	 */
+	RankingCategory currentFilter() const { return filter; }
+	int categorySize(const RankingCategory &category) const;
+	int rankOf(ParticipantStore::Id id) const;
+};
+
+#endif // RANKINGMODEL_H
@@ -1,9 +1,13 @@
 #include "recorder.h"
 #include <QDir>
 #include <QAudioFormat>
-#include <limits>
 
 using std::logic_error;
+/**
+ * @brief Czas (w ms), o jaki nagranie może się opóźnić, zanim zostanie przerwane mimo niepełnej liczby próbek.
+ */
+static const int watchdogMargin = 2000;
+
 /**
  * @brief Konstruktor bezparametrowy. Inicjalizuje recorder.
  * @authors Kamil Wasilewski
@@ -11,9 +15,34 @@ using std::logic_error;
 Recorder::Recorder()
 {
     audio = nullptr;
+	preRoll = 0;
 	InitialiseRecorder();
     //tworzymy timer
 	setupTimer();
+	SetDuration(5000);
+    //próbki analizujemy na bieżąco, w trakcie nagrywania, w osobnym wątku
+	qRegisterMetaType<LevelMetrics>("LevelMetrics");
+	qRegisterMetaType<ToneCheck>("ToneCheck");
+	qRegisterMetaType<QSharedPointer<const FrequencyResponse> >("QSharedPointer<const FrequencyResponse>");
+	qRegisterMetaType<QSharedPointer<WavReader> >("QSharedPointer<WavReader>");
+	qRegisterMetaType<AudioModel::Engine>("AudioModel::Engine");
+	worker = new AnalysisWorker(&sink);
+	worker->moveToThread(&workerThread);
+	connect(&workerThread, SIGNAL(finished()), worker, SLOT(deleteLater()));
+	connect(&sink, SIGNAL(samplesAvailable()), worker, SLOT(drain()));
+	connect(worker, SIGNAL(finished(const LevelMetrics &)), this, SIGNAL(recordingStopped(const LevelMetrics &)));
+	connect(worker, SIGNAL(levelChanged(double)), this, SIGNAL(levelChanged(double)));
+	connect(worker, SIGNAL(stabilityMeasured(double, double, bool)), this, SIGNAL(stabilityMeasured(double, double, bool)));
+	// A settled level ends the recording early; the worker only signals it while a stability target is set.
+	connect(worker, SIGNAL(stabilised()), this, SLOT(Stop()));
+	connect(worker, SIGNAL(toneMeasured(const ToneCheck &)), this, SIGNAL(toneMeasured(const ToneCheck &)));
+	connect(worker, SIGNAL(responseMeasured(const QSharedPointer<const FrequencyResponse> &)),
+			this, SIGNAL(responseMeasured(const QSharedPointer<const FrequencyResponse> &)));
+	// Likewise a missing calibration tone; the worker only signals it while the tone is required.
+	connect(worker, SIGNAL(toneMissing()), this, SLOT(Stop()));
+	// Stop from the event loop, not from inside the audio device's write.
+	connect(&sink, SIGNAL(completed()), this, SLOT(Stop()), Qt::QueuedConnection);
+	workerThread.start();
 }
 /**
  * @brief Destruktor.
@@ -23,6 +52,8 @@ Recorder::~Recorder()
 {
     if (audio != nullptr)
         delete audio;
+    workerThread.quit();
+    workerThread.wait();
 }
 /**
  * @brief Metoda przypisująca zmiennej device parametry wybranego urządzenia wejścia.
@@ -57,24 +88,149 @@ void Recorder::InitialiseRecorder(const QString &deviceName)
 	{
 		qDebug() << "Format not supported, trying to use the nearest.";
 		format = device.nearestFormat(format);
+		// The sink converts any rate and channel count to the analysis format, but not every sample encoding.
+		if (!AudioSink::isSupported(format))
+			format = device.preferredFormat();
 	}
     //wyświetlamy ustawienia
 	printFormat();
     //przypisujemy zmiennej audio urządzenie do nagrywania i format próbek
     audio = new QAudioInput(device, format);
+	this->deviceName = device.deviceName();
+	//w trybie ciągłym nowe urządzenie od razu wypełnia bufor wyprzedzenia
+	if (preRoll > 0)
+		startMonitoring();
+	emit deviceChanged();
 }
 /**
- * @brief Metoda inicjalizująca timer, trwający 5 sekund.
+ * @brief Metoda inicjalizująca timer. Nagranie kończy się po zebraniu ustalonej liczby próbek (AudioSink::completed), a timer
+ * przerywa je tylko wtedy, gdy urządzenie przestanie dostarczać dane.
  * @authors Kamil Wasilewski
  */
 void Recorder::setupTimer()
 {
 	timer.setSingleShot(true);
-    //ustawiamy interwał na 5s
-	timer.setInterval(5000);
     //łączymy timer z sygnałem
 	connect(&timer, SIGNAL(timeout()), this, SLOT(Stop()));
 }
+/**
+ * @brief Metoda ustawiająca długość kolejnych nagrań. Każde nagranie ma dokładnie tyle próbek, ile odpowiada tej długości,
+ * niezależnie od buforowania urządzenia, więc wyniki uczestników są porównywalne, a analiza korzysta z tych samych planów FFT.
+ * @param milliseconds Długość nagrania w milisekundach.
+ * @throw logic_error Gdy długość nie jest dodatnia.
+ */
+void Recorder::SetDuration(int milliseconds)
+{
+	if (milliseconds <= 0)
+		throw logic_error("Długość nagrania musi być dodatnia.");
+	duration = milliseconds;
+	updateTarget();
+	timer.setInterval(milliseconds + watchdogMargin);
+}
+/**
+ * @brief Metoda ustawiająca długość bufora wyprzedzenia. Przy długości dodatniej urządzenie wejścia działa bez przerwy, a każde nagranie
+ * zaczyna się od próbek zebranych tuż przed wywołaniem Start(), bez opóźnienia uruchamiania urządzenia. Bufor jest dodawany
+ * do długości nagrania i trafia do archiwum, ale wynik liczony jest tylko z Duration() po wywołaniu Start(), więc dźwięki sprzed
+ * naciśnięcia przycisku nie zmieniają oceny, a wyniki z buforem i bez niego są porównywalne.
+ * @param milliseconds Długość bufora w milisekundach (najwyżej MaxPreRoll()); 0 wyłącza tryb ciągły.
+ * @throw logic_error Gdy długość jest ujemna lub trwa nagranie.
+ */
+void Recorder::SetPreRoll(int milliseconds)
+{
+	if (milliseconds < 0)
+		throw logic_error("Długość bufora nie może być ujemna.");
+	if (sink.isCapturing())
+		throw logic_error("Nie można zmienić bufora w trakcie nagrywania.");
+	preRoll = qMin(milliseconds, MaxPreRoll());
+	if (audio == nullptr)
+		return;
+	if (preRoll > 0)
+		startMonitoring();
+	else if (sink.isMonitoring())
+	{
+		audio->stop();
+		sink.close();
+	}
+}
+/**
+ * @brief Metoda ustawiająca kryterium wcześniejszego zakończenia nagrania: nagrywanie kończy się, gdy poziom z charakterystyką A
+ * przez zadany czas mieści się w tolerancji, ale nie później niż po czasie ustawionym przez SetDuration().
+ * @param tolerance Dopuszczalne odchylenie poziomu w decybelach; 0 wyłącza wcześniejsze zakończenie.
+ * @param holdMilliseconds Czas, przez który poziom musi mieścić się w tolerancji.
+ * @throw std::logic_error Jeśli trwa nagrywanie.
+ */
+void Recorder::SetStabilityTarget(double tolerance, int holdMilliseconds)
+{
+	if (sink.isCapturing())
+		throw logic_error("Nie można zmienić kryterium stabilności w trakcie nagrywania.");
+	QMetaObject::invokeMethod(worker, "setStabilityTarget", Q_ARG(double, tolerance), Q_ARG(int, holdMilliseconds));
+}
+/**
+ * @brief Metoda ustawiająca, czy nagranie musi zawierać ton kalibracyjny 1 kHz. Jeśli go nie ma, nagrywanie kończy się
+ * już po ToneDetector::precheckBlocks blokach, a wynik sprawdzenia przekazuje sygnał toneMeasured().
+ * @param required true, jeśli nagranie musi zawierać ton kalibracyjny.
+ * @throw std::logic_error Jeśli trwa nagrywanie.
+ */
+void Recorder::SetToneRequired(bool required)
+{
+	if (sink.isCapturing())
+		throw logic_error("Nie można zmienić sprawdzania tonu w trakcie nagrywania.");
+	QMetaObject::invokeMethod(worker, "setToneRequired", Q_ARG(bool, required));
+}
+/**
+ * @brief Metoda włączająca pomiar charakterystyki częstotliwościowej urządzenia w kolejnych nagraniach. Wynik przekazuje sygnał
+ * responseMeasured().
+ * @param enabled true, jeśli nagrania są sygnałem pomiarowym charakterystyki.
+ * @throw std::logic_error Jeśli trwa nagrywanie.
+ */
+void Recorder::SetResponseMeasurement(bool enabled)
+{
+	if (sink.isCapturing())
+		throw logic_error("Nie można zmienić pomiaru charakterystyki w trakcie nagrywania.");
+	QMetaObject::invokeMethod(worker, "setResponseMeasurement", Q_ARG(bool, enabled));
+}
+/**
+ * @brief Metoda ustawiająca krzywą korekcji charakterystyki częstotliwościowej urządzenia. Trwające nagranie liczone jest jeszcze
+ * bez zmiany, korekcja obowiązuje od następnego.
+ * @param response Krzywa korekcji; pusty wskaźnik wyłącza korekcję.
+ */
+void Recorder::SetResponse(const QSharedPointer<const FrequencyResponse> &response)
+{
+	QMetaObject::invokeMethod(worker, "setResponse", Q_ARG(QSharedPointer<const FrequencyResponse>, response));
+}
+/**
+ * @brief Zwraca największą długość bufora wyprzedzenia.
+ * @return Długość w milisekundach.
+ */
+int Recorder::MaxPreRoll()
+{
+	return (int) ((long long) AudioSink::maxPreRoll() * 1000 / AudioModel::sampleRate());
+}
+/**
+ * @brief Metoda wyliczająca liczbę próbek nagrania od wywołania Start(); AudioSink dodaje do niej próbki bufora wyprzedzenia.
+ */
+void Recorder::updateTarget()
+{
+	targetSamples = (long long) AudioModel::sampleRate() * duration / 1000;
+}
+/**
+ * @brief Metoda uruchamiająca urządzenie wejścia w trybie ciągłym. Jeśli format nie jest obsługiwany, tryb ciągły pozostaje wyłączony,
+ * a błąd zgłosi dopiero Start().
+ */
+void Recorder::startMonitoring()
+{
+	audio->stop();
+	try
+	{
+		sink.monitor(format, (int) ((long long) AudioModel::sampleRate() * preRoll / 1000));
+	}
+	catch (exception &e)
+	{
+		qDebug() << "Continuous capture disabled:" << e.what();
+		return;
+	}
+	audio->start(&sink);
+}
 /**
  * @brief Metoda ustawiająca format próbek.
  * @authors Kamil Wasilewski
@@ -90,16 +246,22 @@ void Recorder::setFormatSettings()
 }
 /**
  * @brief Metoda rozpoczynająca proces pobierania dźwięków z urządzenia wejścia do bufora.
+ * @param archiveFile Nazwa pliku WAV, do którego w tle zapisywane jest nagranie; pusta, jeśli nagranie nie ma być archiwizowane.
+ * @throw std::logic_error Jeśli urządzenie dostarcza próbki w nieobsługiwanym formacie.
  * @authors Kamil Wasilewski
  */
-void Recorder::Start()
+void Recorder::Start(const QString &archiveFile)
 {
-    buffer.buffer().clear(); // Flush data from underlying QByteArray internal buffer.
-    //otwieramy buffer i rozpoczynamy nagrywanie
-    buffer.open(QIODevice::ReadWrite);
-    audio->start(&buffer);
+    //otwieramy urządzenie i rozpoczynamy nagrywanie; urządzenie AudioSink dekoduje format wejścia i przepróbkowuje go do częstotliwości analizy
+	//w trybie ciągłym urządzenie wejścia już działa, a nagranie zaczyna się od bufora wyprzedzenia
+	const bool continuous = sink.isMonitoring();
+	sink.start(format, targetSamples);
+	QMetaObject::invokeMethod(worker, "begin", Q_ARG(QString, archiveFile), Q_ARG(int, sink.leadIn()),
+							  Q_ARG(AudioModel::Engine, AudioModel::engine()));
+	if (!continuous)
+		audio->start(&sink);
 
-	// Record 5 seconds.
+	// Record exactly targetSamples samples; the timer is only a watchdog.
     timer.start();
 }
 /**
@@ -108,14 +270,19 @@ void Recorder::Start()
  */
 void Recorder::Stop()
 {
+	if (!sink.isCapturing())
+		return; // Already stopped, e.g. by the user just before a queued stop.
     timer.stop(); // Stop a timer in case user aborts recording.
-    //kończymy nagrywanie i zamykamy buffer
-    audio->stop();
-	buffer.close();
-    //parsujemy zawartość buforu
-	parseBufferContent(buffer.data());
-    //wysyłamy sygnał do metody recordingStopped
-	emit recordingStopped(complexData);
+    //kończymy nagrywanie i zamykamy urządzenie; w trybie ciągłym urządzenie wejścia dalej wypełnia bufor wyprzedzenia
+	if (sink.isMonitoring())
+		sink.finish();
+	else
+	{
+		audio->stop();
+		sink.close();
+	}
+    //wątek analizy przetwarza pozostałe próbki i wysyła sygnał recordingStopped z gotowym wynikiem
+	QMetaObject::invokeMethod(worker, "end");
 }
 /**
  * @brief Metoda wyświetlająca format pobieranych danych.
@@ -146,42 +313,15 @@ QStringList Recorder::GetAvailableDevices() const
 	return devicesNames;
 }
 /**
- * @brief Metoda parsująca dane zawarte w buforze.
- * @authors Kamil Wasilewski
- */
-void Recorder::parseBufferContent(const QByteArray &data)
-{
-	QDataStream stream(data);
-	parse(stream);
-}
-/**
- * @brief Metoda wczytująca dane Audio z pliku.
+ * @brief Metoda wczytująca dane Audio z pliku WAV. Plik jest mapowany do pamięci, a wynik analizy, policzony w wątku analizy,
+ * przychodzi sygnałem recordingStopped. Pliki o innej częstotliwości próbkowania są przepróbkowywane do częstotliwości analizy.
  * @param fileName Nazwa pliku.
+ * @throw std::logic_error Jeśli pliku nie można otworzyć lub ma nieobsługiwany format.
  * @authors Kamil Wasilewski
  */
 void Recorder::LoadAudioDataFromFile(const QString &fileName)
 {
-    QFile file(fileName);
-    file.open(QFile::ReadOnly);
-	file.seek(44); // Skip WAV header.
-    QDataStream fstream(&file);
-	parse(fstream);
-    file.close();
-    emit recordingStopped(complexData);
-}
-/**
- * @brief Metoda parsująca dane.
- * @authors Kamil Wasilewski
- */
-void Recorder::parse(QDataStream &stream)
-{
-	complexData.clear();
-    stream.setByteOrder(QDataStream::LittleEndian); //ustawaimy kolejność bitów
-	while (!stream.atEnd())
-	{
-		short i;
-		stream >> i;
-		double j = (double) i / (double) std::numeric_limits<short>::max(); // Scale to [-1,1] range.
-        complexData.push_back(std::complex<double>(j, 0.0)); //wszelkie zera wysyłamy na koniec danej struktury
-	}
+	QSharedPointer<WavReader> reader(new WavReader(fileName));
+	reader->open();
+	QMetaObject::invokeMethod(worker, "analyse", Q_ARG(QSharedPointer<WavReader>, reader), Q_ARG(AudioModel::Engine, AudioModel::engine()));
 }
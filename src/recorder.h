@@ -4,11 +4,10 @@
 #include <QAudioInput>
 #include <QDebug>
 #include <QTimer>
-#include <QBuffer>
 #include <QStringList>
-#include <QDataStream>
 #include <exception>
-#include <complex>
+#include <QThread>
+#include "analysisworker.h"
 
 using std::exception;
 /**
@@ -20,31 +19,90 @@ class Recorder : public QObject
     Q_OBJECT
     QAudioFormat format;
     QAudioInput *audio;
-    QBuffer buffer;
+	QString deviceName;
+    AudioSink sink;
     QTimer timer;
-	QVector<std::complex<double> > complexData;
+	QThread workerThread;
+	AnalysisWorker *worker;
+	int duration;
+	int preRoll;
+	long long targetSamples;
 
 	void setupTimer();
+	void updateTarget();
+	void startMonitoring();
 	void setFormatSettings();
     void printFormat() const;
-	void parseBufferContent(const QByteArray &data);
-	void parse(QDataStream &stream);
 public:
 	Recorder();
     ~Recorder();
-    void Start();
+    void Start(const QString &archiveFile = QString());
 	QStringList GetAvailableDevices() const;
     void LoadAudioDataFromFile(const QString &fileName);
+	void SetDuration(int milliseconds);
+	/**
+	 * @brief Zwraca długość nagrania.
+	 * @return Długość nagrania w milisekundach.
+	 */
+	int Duration() const { return duration; }
+	void SetPreRoll(int milliseconds);
+	/**
+	 * @brief Zwraca długość bufora wyprzedzenia.
+	 * @return Długość w milisekundach; 0, jeśli urządzenie wejścia jest uruchamiane dopiero na początku nagrania.
+	 */
+	int PreRoll() const { return preRoll; }
+	static int MaxPreRoll();
+	void SetStabilityTarget(double tolerance, int holdMilliseconds);
+	void SetToneRequired(bool required);
+	void SetResponseMeasurement(bool enabled);
+	void SetResponse(const QSharedPointer<const FrequencyResponse> &response);
+	/**
+	 * @brief Zwraca nazwę urządzenia wejścia.
+	 * @return Nazwa urządzenia, z którego nagrywa rejestrator.
+	 */
+	QString DeviceName() const { return deviceName; }
+	/**
+	 * @brief Zwraca format, w jakim nagrywa urządzenie wejścia.
+	 * @return Format wynegocjowany z urządzeniem.
+	 */
+	QAudioFormat Format() const { return format; }
 public slots:
 	void Stop();
 	void InitialiseRecorder(const QString &deviceName = "");
 signals:
+	/**
+	 * @brief Sygnał wysyłany po wybraniu urządzenia wejścia (także tego samego ponownie) i ustaleniu jego formatu.
+	 */
+	void deviceChanged();
+	/**
+	 * @brief Sygnał z bieżącym poziomem w trakcie nagrywania, wysyłany po każdym bloku próbek.
+	 * @param level Poziom z charakterystyką A i uśrednianiem Fast w decybelach (bez danych kalibracyjnych).
+	 */
+	void levelChanged(double level);
+	/**
+	 * @brief Sygnał ze stabilnością poziomu nagrania, wysyłany tuż przed recordingStopped().
+	 * @param level Poziom okna, w którym sygnał się ustalił (albo ostatniego okna) w decybelach, bez danych kalibracyjnych.
+	 * @param deviation Największe odchylenie poziomu w tym oknie w decybelach.
+	 * @param stable true, jeśli poziom ustalił się w tolerancji ustawionej przez SetStabilityTarget().
+	 */
+	void stabilityMeasured(double level, double deviation, bool stable);
+	/**
+	 * @brief Sygnał z wynikiem sprawdzenia tonu kalibracyjnego, wysyłany po każdym nagraniu (także z pliku) tuż przed recordingStopped().
+	 * @param tone Częstotliwość, czystość i poziom tonu (bez danych kalibracyjnych).
+	 */
+	void toneMeasured(const ToneCheck &tone);
+	/**
+	 * @brief Sygnał z krzywą korekcji zmierzoną w nagraniu, wysyłany tuż przed recordingStopped(), jeśli włączono pomiar charakterystyki.
+	 * @param response Krzywa korekcji; pusty wskaźnik, jeśli w nagraniu nie było sygnału pomiarowego.
+	 */
+	void responseMeasured(const QSharedPointer<const FrequencyResponse> &response);
 
    /**
     * @brief Sygnał kończący nagrywanie.
+    * @param metrics Miary głośności nagrania w decybelach (bez danych kalibracyjnych), policzone w trakcie nagrywania.
     * @authors Kamil Wasilewski
     */
-	void recordingStopped(const QVector<std::complex<double> > &complexData);
+	void recordingStopped(const LevelMetrics &metrics);
 };
 
 #endif // RECORDER_H
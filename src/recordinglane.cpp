@@ -0,0 +1,130 @@
+#include "recordinglane.h"
+#include <stdexcept>
+
+using std::logic_error;
+
+/**
+ * @brief Konstruktor. Tworzy rejestrator (z własnym wątkiem analizy) na urządzeniu domyślnym.
+ * @param number Numer stanowiska, liczony od 1.
+ * @param parent Obiekt nadrzędny.
+ */
+RecordingLane::RecordingLane(int number, QObject *parent) : QObject(parent), number(number), calibrator(&recorder),
+	participant(0), calibrating(false)
+{
+	connect(&recorder, SIGNAL(recordingStopped(const LevelMetrics &)), this, SLOT(onRecordingStopped(const LevelMetrics &)));
+	connect(&recorder, SIGNAL(levelChanged(double)), this, SLOT(onLevelChanged(double)));
+	connect(&calibrator, SIGNAL(calibrationStopped()), this, SLOT(onCalibrationStopped()));
+	connect(&calibrator, SIGNAL(calibrationDrifted(double)), this, SLOT(onCalibrationDrifted(double)));
+}
+/**
+ * @brief Zwraca nazwę stanowiska wyświetlaną prowadzącemu.
+ * @return Nazwa z numerem stanowiska.
+ */
+QString RecordingLane::Name() const
+{
+	return tr("Stanowisko %1").arg(number);
+}
+/**
+ * @brief Metoda wybierająca urządzenie wejścia stanowiska.
+ * @param deviceName Nazwa urządzenia; pusta oznacza urządzenie domyślne.
+ * @throw std::logic_error Jeśli stanowisko jest zajęte.
+ */
+void RecordingLane::SetDevice(const QString &deviceName)
+{
+	if (IsBusy())
+		throw logic_error("Nie można zmienić urządzenia w trakcie nagrywania.");
+	if (deviceName == device)
+		return;
+	device = deviceName;
+	recorder.InitialiseRecorder(deviceName);
+}
+/**
+ * @brief Metoda rozpoczynająca nagranie uczestnika.
+ * @param participant Trwałe ID uczestnika; stanowisko pamięta ID, a nie wiersz, bo lista uczestników może się zmienić przed wynikiem.
+ * @param archiveFile Nazwa pliku archiwum nagrania; pusta, jeśli nagranie nie ma być archiwizowane.
+ * @throw std::logic_error Jeśli stanowisko jest zajęte lub urządzenie dostarcza próbki w nieobsługiwanym formacie.
+ */
+void RecordingLane::Record(ParticipantStore::Id participant, const QString &archiveFile)
+{
+	if (IsBusy())
+		throw logic_error("Stanowisko jest zajęte.");
+	recorder.Start(archiveFile);
+	this->participant = participant;
+}
+/**
+ * @brief Metoda rozpoczynająca kalibrację stanowiska z jego urządzenia wejścia.
+ * @throw std::logic_error Jeśli stanowisko jest zajęte lub urządzenie dostarcza próbki w nieobsługiwanym formacie.
+ */
+void RecordingLane::Calibrate()
+{
+	if (IsBusy())
+		throw logic_error("Stanowisko jest zajęte.");
+	calibrator.Calibrate();
+	calibrating = true;
+}
+/**
+ * @brief Metoda kalibrująca stanowisko sygnałem z pliku.
+ * @param fileName Ścieżka do pliku.
+ * @throw std::logic_error Jeśli stanowisko jest zajęte lub pliku nie można wczytać.
+ */
+void RecordingLane::CalibrateFromFile(const QString &fileName)
+{
+	if (IsBusy())
+		throw logic_error("Stanowisko jest zajęte.");
+	calibrator.CalibrateFromFile(fileName);
+	calibrating = true;
+}
+/**
+ * @brief Metoda rozpoczynająca kalibrację charakterystyki częstotliwościowej urządzenia wejścia stanowiska.
+ * @throw std::logic_error Jeśli stanowisko jest zajęte lub urządzenie dostarcza próbki w nieobsługiwanym formacie.
+ */
+void RecordingLane::CalibrateResponse()
+{
+	if (IsBusy())
+		throw logic_error("Stanowisko jest zajęte.");
+	calibrator.CalibrateResponse();
+	calibrating = true;
+}
+/**
+ * @brief Metoda przerywająca nagranie; wynik z zebranych dotąd próbek przychodzi sygnałem recordingStopped.
+ */
+void RecordingLane::Stop()
+{
+	recorder.Stop();
+}
+/**
+ * @brief Slot przekazujący wynik nagrania razem ze stanowiskiem i uczestnikiem. Wyniki kalibracji obsługuje Calibrator.
+ * @param metrics Miary głośności w decybelach (bez danych kalibracyjnych).
+ */
+void RecordingLane::onRecordingStopped(const LevelMetrics &metrics)
+{
+	if (participant == 0)
+		return;
+	const ParticipantStore::Id finished = participant;
+	participant = 0;
+	emit recordingStopped(this, finished, metrics);
+}
+/**
+ * @brief Slot przekazujący bieżący poziom razem ze stanowiskiem.
+ * @param level Poziom w decybelach (bez danych kalibracyjnych).
+ */
+void RecordingLane::onLevelChanged(double level)
+{
+	emit levelChanged(this, level);
+}
+/**
+ * @brief Slot kończący kalibrację stanowiska.
+ */
+void RecordingLane::onCalibrationStopped()
+{
+	calibrating = false;
+	emit calibrationStopped(this);
+}
+/**
+ * @brief Slot przekazujący odchyłkę kalibracji razem ze stanowiskiem.
+ * @param drift Różnica poziomów w decybelach.
+ */
+void RecordingLane::onCalibrationDrifted(double drift)
+{
+	emit calibrationDrifted(this, drift);
+}
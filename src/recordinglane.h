@@ -0,0 +1,110 @@
+#ifndef RECORDINGLANE_H
+#define RECORDINGLANE_H
+
+#include <QObject>
+#include <QString>
+#include "calibrator.h"
+#include "participantstore.h"
+#include "recorder.h"
+
+/**
+ * @brief Stanowisko konkursu: rejestrator z własnym urządzeniem wejścia, formatem, kalibracją i wątkiem analizy, przypisany
+ * na czas nagrania do jednego uczestnika. Stanowiska nie współdzielą żadnego stanu na ścieżce próbek, więc kilka z nich
+ * nagrywa i ocenia jednocześnie, każde na osobnym rdzeniu.
+ */
+class RecordingLane : public QObject
+{
+	Q_OBJECT
+	int number;
+	Recorder recorder;
+	Calibrator calibrator;
+	QString device;
+	ParticipantStore::Id participant;
+	bool calibrating;
+public:
+	explicit RecordingLane(int number, QObject *parent = nullptr);
+	/**
+	 * @brief Zwraca numer stanowiska.
+	 * @return Numer, liczony od 1.
+	 */
+	int Number() const { return number; }
+	QString Name() const;
+	/**
+	 * @brief Zwraca nazwę urządzenia wejścia stanowiska.
+	 * @return Nazwa urządzenia; pusta oznacza urządzenie domyślne.
+	 */
+	QString Device() const { return device; }
+	void SetDevice(const QString &deviceName);
+	/**
+	 * @brief Zwraca uczestnika, którego nagranie trwa lub jest oceniane.
+	 * @return Trwałe ID uczestnika lub 0, jeśli stanowisko go nie ma.
+	 */
+	ParticipantStore::Id Participant() const { return participant; }
+	/**
+	 * @brief Sprawdza, czy stanowisko nagrywa, ocenia nagranie lub jest kalibrowane.
+	 * @return true, jeśli stanowisko jest zajęte.
+	 */
+	bool IsBusy() const { return participant != 0 || calibrating; }
+	/**
+	 * @brief Sprawdza, czy stanowisko jest kalibrowane.
+	 * @return true w trakcie kalibracji.
+	 */
+	bool IsCalibrating() const { return calibrating; }
+	/**
+	 * @brief Zwraca dane kalibracyjne stanowiska.
+	 * @return Poprawka w decybelach dodawana do wyników.
+	 */
+	double CalibrationData() const { return calibrator.CalibrationData(); }
+	/**
+	 * @brief Zwraca czas pomiaru, z którego pochodzą dane kalibracyjne stanowiska.
+	 * @return Czas pomiaru; nieprawidłowy, jeśli urządzenie stanowiska nie było kalibrowane.
+	 */
+	QDateTime CalibrationTime() const { return calibrator.CalibrationTime(); }
+	/**
+	 * @brief Zwraca rejestrator stanowiska.
+	 * @return Rejestrator.
+	 */
+	Recorder &GetRecorder() { return recorder; }
+	/**
+	 * @brief Zwraca kalibrator stanowiska.
+	 * @return Kalibrator.
+	 */
+	Calibrator &GetCalibrator() { return calibrator; }
+	void Record(ParticipantStore::Id participant, const QString &archiveFile);
+	void Calibrate();
+	void CalibrateFromFile(const QString &fileName);
+	void CalibrateResponse();
+	void Stop();
+signals:
+	/**
+	 * @brief Sygnał z wynikiem nagrania uczestnika.
+	 * @param lane Stanowisko.
+	 * @param participant Trwałe ID uczestnika; mogło przestać istnieć w trakcie nagrania (np. po imporcie listy).
+	 * @param metrics Miary głośności w decybelach (bez danych kalibracyjnych).
+	 */
+	void recordingStopped(RecordingLane *lane, ParticipantStore::Id participant, const LevelMetrics &metrics);
+	/**
+	 * @brief Sygnał z bieżącym poziomem w trakcie nagrywania lub kalibracji.
+	 * @param lane Stanowisko.
+	 * @param level Poziom w decybelach (bez danych kalibracyjnych).
+	 */
+	void levelChanged(RecordingLane *lane, double level);
+	/**
+	 * @brief Sygnał kończący kalibrację stanowiska.
+	 * @param lane Stanowisko.
+	 */
+	void calibrationStopped(RecordingLane *lane);
+	/**
+	 * @brief Sygnał wysyłany, gdy ton kalibracyjny nagrany na stanowisku ma po kalibracji poziom inny niż 94 dB.
+	 * @param lane Stanowisko.
+	 * @param drift Różnica poziomów w decybelach.
+	 */
+	void calibrationDrifted(RecordingLane *lane, double drift);
+private slots:
+	void onRecordingStopped(const LevelMetrics &metrics);
+	void onLevelChanged(double level);
+	void onCalibrationStopped();
+	void onCalibrationDrifted(double drift);
+};
+
+#endif // RECORDINGLANE_H
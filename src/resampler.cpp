@@ -0,0 +1,122 @@
+#define _USE_MATH_DEFINES
+
+#include "resampler.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Parametr okna Kaisera (tłumienie w paśmie zaporowym ok. 80 dB).
+ */
+static const double kaiserBeta = 8.0;
+/**
+ * @brief Część pasma Nyquista (niższej z częstotliwości), którą filtr przepuszcza.
+ */
+static const double passband = 0.92;
+
+/**
+ * @brief Zmodyfikowana funkcja Bessela pierwszego rodzaju rzędu 0 (do okna Kaisera).
+ */
+static double besselI0(double x)
+{
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50; ++k)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+/**
+ * @brief Konstruktor.
+ * @param inputRate Częstotliwość próbkowania sygnału wejściowego w Hz.
+ * @param outputRate Częstotliwość próbkowania sygnału wyjściowego w Hz.
+ * @param tapsPerPhase Długość filtra każdej fazy (im większa, tym węższe pasmo przejściowe).
+ */
+Resampler::Resampler(int inputRate, int outputRate, int tapsPerPhase) : inRate(inputRate), outRate(outputRate), taps(tapsPerPhase)
+{
+	int a = inputRate, b = outputRate;
+	while (b != 0)
+	{
+		const int t = a % b;
+		a = b;
+		b = t;
+	}
+	up = outputRate / a;
+	down = inputRate / a;
+	design();
+	reset();
+}
+/**
+ * @brief Metoda projektująca filtr prototypowy i dzieląca go na fazy.
+ */
+void Resampler::design()
+{
+	const int length = up * taps;
+	// Cut-off relative to the upsampled rate (up * input rate), below the lower of the two Nyquist frequencies.
+	const double cutoff = passband * 0.5 / std::max(up, down);
+	const double centre = (length - 1) / 2.0;
+	const double norm = besselI0(kaiserBeta);
+	QVector<double> prototype(length);
+	for (int j = 0; j < length; ++j)
+	{
+		const double t = j - centre;
+		const double sinc = t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+		const double r = t / centre;
+		prototype[j] = sinc * besselI0(kaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+	}
+	// Phase p uses taps p, p + up, p + 2 up, ...; the gain of up restores the level lost to zero stuffing.
+	coefficients.resize(length);
+	for (int p = 0; p < up; ++p)
+		for (int k = 0; k < taps; ++k)
+			coefficients[p * taps + k] = up * prototype[p + k * up];
+}
+/**
+ * @brief Metoda zerująca stan filtra przed nowym sygnałem.
+ */
+void Resampler::reset()
+{
+	buffer.fill(0.0, taps - 1);
+	position = 0;
+}
+/**
+ * @brief Zwraca największą liczbę próbek, jaką może zwrócić process() dla podanej liczby próbek wejściowych.
+ * @param count Liczba próbek wejściowych.
+ * @return Liczba próbek wyjściowych.
+ */
+int Resampler::maxOutput(int count) const
+{
+	return (int) (((long long) count * up) / down) + 1;
+}
+/**
+ * @brief Metoda przetwarzająca blok próbek.
+ * @param in Próbki wejściowe.
+ * @param count Liczba próbek wejściowych.
+ * @param out Bufor wyjściowy na co najmniej maxOutput(count) próbek.
+ * @return Liczba próbek wyjściowych.
+ */
+int Resampler::process(const Sample *in, int count, Sample *out)
+{
+	// The buffer holds the last taps - 1 input samples followed by the new block.
+	const int history = taps - 1;
+	buffer.resize(history + count);
+	std::copy(in, in + count, buffer.data() + history);
+	const Sample *x = buffer.constData() + history;
+
+	int produced = 0;
+	// position is the time of the next output sample in units of 1 / up input samples, relative to in[0].
+	for (; position < (long long) count * up; position += down)
+	{
+		const int index = (int) (position / up);
+		const double *c = coefficients.constData() + (position % up) * taps;
+		const Sample *s = x + index;
+		double y = 0.0;
+		for (int k = 0; k < taps; ++k)
+			y += c[k] * s[-k];
+		out[produced++] = (Sample) y;
+	}
+	position -= (long long) count * up;
+	std::copy(buffer.constData() + count, buffer.constData() + count + history, buffer.data());
+	return produced;
+}
@@ -0,0 +1,47 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <QVector>
+#include "audiomodel.h"
+
+/**
+ * @brief Strumieniowa zmiana częstotliwości próbkowania o wymierny współczynnik L / M (np. 160 / 147 dla 44,1 -> 48 kHz)
+ * filtrem polifazowym. Prototypem jest dolnoprzepustowy filtr sinc z oknem Kaisera, podzielony na L faz, więc dla każdej
+ * próbki wyjściowej liczony jest tylko jeden splot o długości tapsPerPhase, bez wstawiania zer. Stan filtra zachowywany jest
+ * między wywołaniami process(), więc sygnał można przetwarzać kolejnymi blokami.
+ */
+class Resampler
+{
+	int inRate;
+	int outRate;
+	int up;
+	int down;
+	int taps;
+	QVector<double> coefficients;
+	QVector<Sample> buffer;
+	long long position;
+
+	void design();
+public:
+	Resampler(int inputRate, int outputRate, int tapsPerPhase = 48);
+	void reset();
+	int process(const Sample *in, int count, Sample *out);
+	int maxOutput(int count) const;
+	/**
+	 * @brief Zwraca częstotliwość próbkowania sygnału wejściowego.
+	 * @return Częstotliwość w Hz.
+	 */
+	int inputRate() const { return inRate; }
+	/**
+	 * @brief Zwraca częstotliwość próbkowania sygnału wyjściowego.
+	 * @return Częstotliwość w Hz.
+	 */
+	int outputRate() const { return outRate; }
+	/**
+	 * @brief Zwraca opóźnienie grupowe filtra (filtr ma liniową fazę, więc jest jednakowe dla wszystkich częstotliwości).
+	 * @return Opóźnienie w próbkach wejściowych.
+	 */
+	double delay() const { return (up * taps - 1) / 2.0 / up; }
+};
+
+#endif // RESAMPLER_H
@@ -0,0 +1,68 @@
+#define _USE_MATH_DEFINES
+
+#include "responsemeter.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Konstruktor. Przydziela bufory ramki i przypina plan FFT.
+ */
+ResponseMeter::ResponseMeter() : frame(frameSize), window(frameSize), energy(frameSize / 2 + 1), transform(frameSize, FftPlanCache::RealForward),
+	enabled(false)
+{
+	for (int i = 0; i < frameSize; ++i)
+		window[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / frameSize);
+	reset();
+}
+/**
+ * @brief Metoda zerująca sumy przed nowym nagraniem.
+ */
+void ResponseMeter::reset()
+{
+	filled = 0;
+	energy.fill(0.0);
+}
+/**
+ * @brief Metoda dodająca kolejne próbki. Każda zapełniona ramka jest od razu analizowana; niepełna ramka na końcu nagrania jest pomijana.
+ * @param samples Próbki sygnału (w zakresie [-1,1]).
+ * @param count Liczba próbek.
+ */
+void ResponseMeter::consume(const Sample *samples, int count)
+{
+	if (!enabled)
+		return;
+	while (count > 0)
+	{
+		const int n = std::min(count, frameSize - filled);
+		std::copy(samples, samples + n, frame.data() + filled);
+		filled += n;
+		samples += n;
+		count -= n;
+		if (filled == frameSize)
+			analyseFrame();
+	}
+}
+/**
+ * @brief Metoda dodająca energię prążków zgromadzonej ramki do sum i opróżniająca ramkę.
+ */
+void ResponseMeter::analyseFrame()
+{
+	double *in = transform.realIn();
+	for (int i = 0; i < frameSize; ++i)
+		in[i] = frame[i] * window[i];
+	transform.execute();
+	const fftw_complex *xdft = transform.complexOut();
+	for (int i = 0; i < energy.length(); ++i)
+		energy[i] += xdft[i][0] * xdft[i][0] + xdft[i][1] * xdft[i][1];
+	filled = 0;
+}
+/**
+ * @brief Metoda kończąca pomiar.
+ * @return Krzywa korekcji; pusty wskaźnik, jeśli pomiar był wyłączony albo nagranie nie zawierało sygnału w paśmie 1 kHz.
+ */
+QSharedPointer<const FrequencyResponse> ResponseMeter::finish()
+{
+	if (!enabled)
+		return QSharedPointer<const FrequencyResponse>();
+	return FrequencyResponse::measure(energy.constData(), frameSize, AudioModel::sampleRate());
+}
@@ -0,0 +1,47 @@
+#ifndef RESPONSEMETER_H
+#define RESPONSEMETER_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include "fftplancache.h"
+#include "frequencyresponse.h"
+#include "sampleconsumer.h"
+
+/**
+ * @brief Pomiar charakterystyki częstotliwościowej urządzenia wejścia w trakcie kalibracji: sumuje energię prążków widma kolejnych
+ * ramek (z oknem Hanna, ograniczającym przeciek między pasmami), a po zakończeniu nagrania wyznacza z niej krzywą korekcji
+ * (FrequencyResponse::measure). Wyłączony pomiar nie przetwarza próbek, więc zwykłe nagrania nie ponoszą jego kosztu.
+ */
+class ResponseMeter : public SampleConsumer
+{
+	QVector<double> frame;
+	QVector<double> window;
+	QVector<double> energy;
+	FftPlanCache::Binding transform;
+	int filled;
+	bool enabled;
+
+	void analyseFrame();
+public:
+	/**
+	 * @brief Liczba próbek w jednej ramce (ok. 5.9 Hz na prążek przy 48 kHz).
+	 */
+	static const int frameSize = 8192;
+
+	ResponseMeter();
+	void reset();
+	/**
+	 * @brief Włącza lub wyłącza pomiar. Obowiązuje do następnego wywołania.
+	 * @param enabled true, jeśli nagranie jest sygnałem pomiarowym charakterystyki.
+	 */
+	void setEnabled(bool enabled) { this->enabled = enabled; }
+	/**
+	 * @brief Sprawdza, czy pomiar jest włączony.
+	 * @return true, jeśli pomiar jest włączony.
+	 */
+	bool isEnabled() const { return enabled; }
+	void consume(const Sample *samples, int count) override;
+	QSharedPointer<const FrequencyResponse> finish();
+};
+
+#endif // RESPONSEMETER_H
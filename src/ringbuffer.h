@@ -0,0 +1,89 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <QAtomicInteger>
+#include <QVector>
+
+/**
+ * @brief Bufor cykliczny bez blokad dla jednego producenta i jednego konsumenta (SPSC). Pamięć przydzielana jest raz, w konstruktorze;
+ * producent zapisuje, a konsument czyta bezpośrednio w pamięci bufora przez spójne fragmenty zwracane przez acquireWrite/acquireRead,
+ * więc dane nie są kopiowane drugi raz. Pozycje są licznikami bez zawijania, a pojemność potęgą dwójki, dlatego różnica pozycji
+ * zawsze daje liczbę elementów w buforze.
+ */
+template <typename T>
+class RingBuffer
+{
+	QVector<T> storage;
+	quint32 mask;
+	QAtomicInteger<quint32> readPosition;
+	QAtomicInteger<quint32> writePosition;
+
+public:
+	/**
+	 * @brief Konstruktor.
+	 * @param minimumCapacity Najmniejsza pojemność; zaokrąglana w górę do potęgi dwójki.
+	 */
+	explicit RingBuffer(int minimumCapacity) : readPosition(0), writePosition(0)
+	{
+		int capacity = 1;
+		while (capacity < minimumCapacity)
+			capacity *= 2;
+		storage.resize(capacity);
+		mask = capacity - 1;
+	}
+	/**
+	 * @brief Zwraca pojemność bufora.
+	 * @return Liczba elementów.
+	 */
+	int capacity() const { return storage.size(); }
+	/**
+	 * @brief Zwraca liczbę elementów gotowych do odczytu. Wywoływana przez konsumenta.
+	 * @return Liczba elementów.
+	 */
+	int available() const { return (int) (writePosition.loadAcquire() - readPosition.load()); }
+	/**
+	 * @brief Zwraca spójny fragment wolnego miejsca. Wywoływana przez producenta.
+	 * @param count Zwracana długość fragmentu (0, gdy bufor jest pełny).
+	 * @return Początek fragmentu.
+	 */
+	T *acquireWrite(int &count)
+	{
+		const quint32 write = writePosition.load();
+		const int offset = (int) (write & mask);
+		const int space = capacity() - (int) (write - readPosition.loadAcquire());
+		count = qMin(space, capacity() - offset);
+		return storage.data() + offset;
+	}
+	/**
+	 * @brief Udostępnia konsumentowi elementy zapisane we fragmencie z acquireWrite.
+	 * @param count Liczba zapisanych elementów.
+	 */
+	void commitWrite(int count) { writePosition.storeRelease(writePosition.load() + count); }
+	/**
+	 * @brief Zwraca spójny fragment danych gotowych do odczytu. Wywoływana przez konsumenta.
+	 * @param count Zwracana długość fragmentu (0, gdy bufor jest pusty).
+	 * @return Początek fragmentu.
+	 */
+	const T *acquireRead(int &count) const
+	{
+		const quint32 read = readPosition.load();
+		const int offset = (int) (read & mask);
+		count = qMin((int) (writePosition.loadAcquire() - read), capacity() - offset);
+		return storage.constData() + offset;
+	}
+	/**
+	 * @brief Zwalnia odczytane elementy dla producenta.
+	 * @param count Liczba odczytanych elementów.
+	 */
+	void commitRead(int count) { readPosition.storeRelease(readPosition.load() + count); }
+	/**
+	 * @brief Opróżnia bufor. Wolno ją wywołać tylko wtedy, gdy ani producent, ani konsument z niego nie korzystają.
+	 */
+	void clear()
+	{
+		readPosition.store(0);
+		writePosition.store(0);
+	}
+};
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,21 @@
+#ifndef SAMPLECONSUMER_H
+#define SAMPLECONSUMER_H
+
+#include "audiomodel.h"
+
+/**
+ * @brief Interfejs odbiorcy próbek nagrania. AudioSink przekazuje każdemu odbiorcy te same bloki próbek, bez kopiowania.
+ */
+class SampleConsumer
+{
+public:
+	virtual ~SampleConsumer() {}
+	/**
+	 * @brief Metoda przyjmująca kolejny blok próbek. Wskaźnik jest ważny tylko w trakcie wywołania.
+	 * @param samples Próbki sygnału (w zakresie [-1,1]).
+	 * @param count Liczba próbek.
+	 */
+	virtual void consume(const Sample *samples, int count) = 0;
+};
+
+#endif // SAMPLECONSUMER_H
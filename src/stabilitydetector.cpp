@@ -0,0 +1,122 @@
+#include "stabilitydetector.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Konstruktor. Domyślnie detektor nie ma tolerancji, a okno obejmuje 300 ms.
+ * @param parent Obiekt nadrzędny.
+ */
+StabilityDetector::StabilityDetector(QObject *parent) : QObject(parent), filter(AudioModel::sampleRate()), tolerance(0.0)
+{
+	setTarget(0.0, 300);
+}
+/**
+ * @brief Metoda ustawiająca kryterium stabilności. Zeruje stan detektora.
+ * @param toleranceDb Dopuszczalne odchylenie poziomu odcinka od poziomu okna w decybelach; 0 wyłącza wysyłanie sygnału stabilised().
+ * @param holdMilliseconds Czas, przez który poziom musi mieścić się w tolerancji (zaokrąglany w górę do całych odcinków, co najmniej 2).
+ */
+void StabilityDetector::setTarget(double toleranceDb, int holdMilliseconds)
+{
+	tolerance = std::max(0.0, toleranceDb);
+	const long long holdSamples = (long long) std::max(0, holdMilliseconds) * AudioModel::sampleRate() / 1000;
+	energies.resize(std::max(2, (int) ((holdSamples + segmentLength - 1) / segmentLength)));
+	reset();
+}
+/**
+ * @brief Metoda zerująca stan detektora przed nowym nagraniem. Kryterium stabilności pozostaje bez zmian.
+ */
+void StabilityDetector::reset()
+{
+	filter.reset();
+	segmentEnergy = 0.0;
+	filled = 0;
+	segments = 0;
+	energies.fill(0.0);
+	position = 0;
+	stable = false;
+	stableLevel = 0.0;
+	stableDeviation = 0.0;
+}
+/**
+ * @brief Metoda przetwarzająca blok próbek. Każdy zakończony odcinek jest od razu oceniany.
+ * @param samples Próbki sygnału (w zakresie [-1,1]).
+ * @param count Liczba próbek.
+ */
+void StabilityDetector::consume(const Sample *samples, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		const double y = filter.process(samples[i]);
+		segmentEnergy += y * y;
+		if (++filled == segmentLength)
+			endSegment();
+	}
+}
+/**
+ * @brief Metoda zapisująca energię zakończonego odcinka w oknie i sprawdzająca kryterium stabilności.
+ */
+void StabilityDetector::endSegment()
+{
+	const double energy = segmentEnergy;
+	segmentEnergy = 0.0;
+	filled = 0;
+	if (stable || ++segments <= settlingSegments)
+		return; // The stable window is kept for the result; settling segments are never part of it.
+	energies[position] = energy;
+	if (++position == energies.length())
+		position = 0;
+	if (tolerance <= 0.0 || segments - settlingSegments < energies.length())
+		return;
+	double level, spread;
+	measure(level, spread);
+	if (spread <= tolerance)
+	{
+		stable = true;
+		stableLevel = level;
+		stableDeviation = spread;
+		emit stabilised();
+	}
+}
+/**
+ * @brief Metoda mierząca poziom i rozrzut wypełnionej części okna.
+ * @param level Poziom równoważny okna w decybelach (bez danych kalibracyjnych).
+ * @param deviation Największe odchylenie poziomu odcinka od poziomu okna w decybelach.
+ */
+void StabilityDetector::measure(double &level, double &deviation) const
+{
+	const int count = std::min(std::max(segments - settlingSegments, 0), energies.length());
+	level = 0.0;
+	deviation = 0.0;
+	if (count == 0)
+		return;
+	double sum = 0.0;
+	for (int i = 0; i < count; ++i)
+		sum += energies[i];
+	level = AudioModel::toDecibels(sum, (long long) count * segmentLength, 0.0);
+	for (int i = 0; i < count; ++i)
+		deviation = std::max(deviation, std::fabs(AudioModel::toDecibels(energies[i], segmentLength, 0.0) - level));
+}
+/**
+ * @brief Zwraca poziom, przy którym sygnał się ustalił, a jeśli się nie ustalił, poziom ostatniego okna.
+ * @return Poziom z charakterystyką A w decybelach (bez danych kalibracyjnych).
+ */
+double StabilityDetector::level() const
+{
+	if (stable)
+		return stableLevel;
+	double level, spread;
+	measure(level, spread);
+	return level;
+}
+/**
+ * @brief Zwraca rozrzut poziomu w oknie, w którym sygnał się ustalił, a jeśli się nie ustalił, w ostatnim oknie.
+ * @return Największe odchylenie poziomu odcinka od poziomu okna w decybelach.
+ */
+double StabilityDetector::deviation() const
+{
+	if (stable)
+		return stableDeviation;
+	double level, spread;
+	measure(level, spread);
+	return spread;
+}
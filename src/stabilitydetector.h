@@ -0,0 +1,59 @@
+#ifndef STABILITYDETECTOR_H
+#define STABILITYDETECTOR_H
+
+#include <QObject>
+#include <QVector>
+#include "aweightingfilter.h"
+#include "sampleconsumer.h"
+
+/**
+ * @brief Detektor ustalenia się poziomu sygnału kalibracyjnego. Sygnał dzielony jest na odcinki po segmentLength próbek, a dla każdego
+ * liczony jest poziom z charakterystyką A. Poziom uznawany jest za stabilny, gdy wszystkie odcinki z okna o zadanej długości mieszczą się
+ * w zadanej tolerancji wokół poziomu równoważnego tego okna. Pierwsze odcinki (stan nieustalony filtra i włączanie źródła) są pomijane.
+ * Bez ustawionej tolerancji detektor tylko mierzy rozrzut ostatniego okna i nie wysyła sygnału.
+ */
+class StabilityDetector : public QObject, public SampleConsumer
+{
+	Q_OBJECT
+	AWeightingFilter filter;
+	double segmentEnergy;
+	int filled;
+	int segments;
+	QVector<double> energies;
+	int position;
+	double tolerance;
+	bool stable;
+	double stableLevel;
+	double stableDeviation;
+
+	void endSegment();
+	void measure(double &level, double &deviation) const;
+public:
+	/**
+	 * @brief Liczba próbek w jednym odcinku (50 ms przy 48 kHz).
+	 */
+	static const int segmentLength = 2400;
+	/**
+	 * @brief Liczba początkowych odcinków pomijanych przy ocenie stabilności.
+	 */
+	static const int settlingSegments = 2;
+
+	explicit StabilityDetector(QObject *parent = nullptr);
+	void setTarget(double toleranceDb, int holdMilliseconds);
+	void reset();
+	void consume(const Sample *samples, int count) override;
+	/**
+	 * @brief Sprawdza, czy poziom już się ustalił.
+	 * @return true, jeśli od ostatniego reset() okno odcinków zmieściło się w tolerancji.
+	 */
+	bool isStable() const { return stable; }
+	double level() const;
+	double deviation() const;
+signals:
+	/**
+	 * @brief Sygnał wysyłany raz na nagranie, gdy poziom się ustali.
+	 */
+	void stabilised();
+};
+
+#endif // STABILITYDETECTOR_H
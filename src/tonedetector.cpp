@@ -0,0 +1,95 @@
+#define _USE_MATH_DEFINES
+
+#include "tonedetector.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Konstruktor. Wylicza współczynniki filtru Goertzla dla prążka tonu kalibracyjnego.
+ * @param parent Obiekt nadrzędny.
+ */
+ToneDetector::ToneDetector(QObject *parent) : QObject(parent), required(false)
+{
+	const double w = 2.0 * M_PI * toneFrequency / AudioModel::sampleRate();
+	coefficient = 2.0 * std::cos(w);
+	cosine = std::cos(w);
+	sine = std::sin(w);
+	reset();
+}
+/**
+ * @brief Metoda zerująca stan detektora przed nowym nagraniem. Ustawienie setRequired() pozostaje bez zmian.
+ */
+void ToneDetector::reset()
+{
+	s1 = s2 = 0.0;
+	blockEnergy = 0.0;
+	filled = 0;
+	blocks = 0;
+	toneEnergy = 0.0;
+	totalEnergy = 0.0;
+	previousRe = previousIm = 0.0;
+	rotationRe = rotationIm = 0.0;
+}
+/**
+ * @brief Metoda przetwarzająca blok próbek. Każdy zakończony blok Goertzla jest od razu oceniany; niepełny blok na końcu nagrania jest pomijany.
+ * @param samples Próbki sygnału (w zakresie [-1,1]).
+ * @param count Liczba próbek.
+ */
+void ToneDetector::consume(const Sample *samples, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		const double x = samples[i];
+		const double s0 = x + coefficient * s1 - s2;
+		s2 = s1;
+		s1 = s0;
+		blockEnergy += x * x;
+		if (++filled == blockLength)
+			endBlock();
+	}
+}
+/**
+ * @brief Metoda kończąca blok: dodaje energię tonu i całego sygnału, a przyrost fazy prążka względem poprzedniego bloku
+ * dodaje (ważony amplitudą) do oszacowania częstotliwości.
+ */
+void ToneDetector::endBlock()
+{
+	// X[k] = s1 * e^(jw) - s2, because the block holds a whole number of periods of the bin frequency.
+	const double re = s1 * cosine - s2;
+	const double im = s1 * sine;
+	// A sine of amplitude A gives |X| = A * N / 2 and block energy A^2 * N / 2.
+	toneEnergy += 2.0 * (re * re + im * im) / blockLength;
+	totalEnergy += blockEnergy;
+	if (blocks > 0)
+	{
+		// X[b] * conj(X[b - 1]) turns by 2 pi * (f - f0) * N / fs per block.
+		rotationRe += re * previousRe + im * previousIm;
+		rotationIm += im * previousRe - re * previousIm;
+	}
+	previousRe = re;
+	previousIm = im;
+	s1 = s2 = 0.0;
+	blockEnergy = 0.0;
+	filled = 0;
+	if (++blocks == precheckBlocks && required && !result().present)
+		emit toneMissing();
+}
+/**
+ * @brief Zwraca wynik sprawdzenia wszystkich pełnych bloków od ostatniego reset().
+ * @return Częstotliwość, czystość i poziom tonu oraz ocena, czy jest to ton kalibracyjny.
+ */
+ToneCheck ToneDetector::result() const
+{
+	ToneCheck check;
+	if (blocks < 2 || totalEnergy <= 0.0)
+		return check;
+	check.frequency = toneFrequency + std::atan2(rotationIm, rotationRe) * AudioModel::sampleRate() / (2.0 * M_PI * blockLength);
+	// A tone off the bin centre loses (sin x / x)^2 of its energy in the bin; undo that for the measured frequency.
+	const double x = M_PI * (check.frequency - toneFrequency) * blockLength / AudioModel::sampleRate();
+	const double gain = x == 0.0 ? 1.0 : std::pow(std::sin(x) / x, 2);
+	const double energy = toneEnergy / gain;
+	check.purity = std::min(energy / totalEnergy, 1.0);
+	check.level = AudioModel::toDecibels(energy, (long long) blocks * blockLength, 0.0);
+	check.present = std::fabs(check.frequency - toneFrequency) <= frequencyTolerance && check.purity >= minPurity && check.level >= minLevel;
+	return check;
+}
@@ -0,0 +1,91 @@
+#ifndef TONEDETECTOR_H
+#define TONEDETECTOR_H
+
+#include <QMetaType>
+#include <QObject>
+#include "sampleconsumer.h"
+
+/**
+ * @brief Wynik sprawdzenia sygnału kalibracyjnego przez ToneDetector.
+ */
+struct ToneCheck
+{
+	bool present; /**< Czy nagranie zawiera ton kalibracyjny (częstotliwość, czystość i poziom w granicach). */
+	double frequency; /**< Zmierzona częstotliwość tonu w Hz. */
+	double purity; /**< Udział energii tonu w energii całego sygnału (od 0 do 1). */
+	double level; /**< Poziom tonu w decybelach (bez danych kalibracyjnych); przy 1 kHz charakterystyka A go nie zmienia. */
+
+	ToneCheck() : present(false), frequency(0.0), purity(0.0), level(-1000.0) {}
+};
+
+Q_DECLARE_METATYPE(ToneCheck)
+
+/**
+ * @brief Wąskopasmowy detektor tonu kalibracyjnego 1 kHz liczony algorytmem Goertzla: dla każdego bloku po blockLength próbek wyznacza
+ * tylko jeden prążek widma, w czasie O(n) i bez transformaty całego widma. Częstotliwość mierzona jest z przyrostu fazy prążka między
+ * kolejnymi blokami, czystość jako stosunek energii tonu do energii całego sygnału, a poziom z energii tonu.
+ * Gdy ton jest wymagany, po pierwszych precheckBlocks blokach bez tonu detektor raz wysyła sygnał toneMissing(), aby kalibrację
+ * z niewłaściwego urządzenia można było przerwać od razu.
+ */
+class ToneDetector : public QObject, public SampleConsumer
+{
+	Q_OBJECT
+	double coefficient;
+	double cosine;
+	double sine;
+	double s1, s2;
+	double blockEnergy;
+	int filled;
+	int blocks;
+	double toneEnergy;
+	double totalEnergy;
+	double previousRe, previousIm;
+	double rotationRe, rotationIm;
+	bool required;
+
+	void endBlock();
+public:
+	/**
+	 * @brief Częstotliwość tonu kalibracyjnego w Hz.
+	 */
+	static constexpr double toneFrequency = 1000.0;
+	/**
+	 * @brief Liczba próbek w bloku (10 ms przy 48 kHz). Blok mieści całkowitą liczbę okresów tonu, więc prążek nie przecieka,
+	 * a przyrost fazy między blokami jednoznacznie wyznacza częstotliwość w zakresie ±50 Hz.
+	 */
+	static const int blockLength = 480;
+	/**
+	 * @brief Liczba bloków, po których sprawdzana jest obecność tonu (300 ms).
+	 */
+	static const int precheckBlocks = 30;
+	/**
+	 * @brief Dopuszczalna odchyłka częstotliwości tonu w Hz. Poza tolerancją kalibratora obejmuje niedokładny zegar karty dźwiękowej
+	 * (dołączone nagranie kalibracja.wav ma ok. 1026 Hz).
+	 */
+	static constexpr double frequencyTolerance = 40.0;
+	/**
+	 * @brief Najmniejszy udział energii tonu w energii sygnału.
+	 */
+	static constexpr double minPurity = 0.9;
+	/**
+	 * @brief Najmniejszy poziom tonu w decybelach (bez danych kalibracyjnych).
+	 */
+	static constexpr double minLevel = -70.0;
+
+	explicit ToneDetector(QObject *parent = nullptr);
+	void reset();
+	/**
+	 * @brief Ustawia, czy brak tonu ma być zgłaszany sygnałem toneMissing(). Obowiązuje do następnego wywołania.
+	 * @param required true, jeśli nagranie musi zawierać ton kalibracyjny.
+	 */
+	void setRequired(bool required) { this->required = required; }
+	void consume(const Sample *samples, int count) override;
+	ToneCheck result() const;
+signals:
+	/**
+	 * @brief Sygnał wysyłany raz na nagranie, jeśli ton jest wymagany, a w pierwszych blokach go nie wykryto.
+	 */
+	void toneMissing();
+};
+
+#endif // TONEDETECTOR_H
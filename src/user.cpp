@@ -1,63 +1,83 @@
 #include "user.h"
-QList<User> User::registeredUsers;
+ParticipantStore User::registeredUsers;
 
 /**
- * @brief Konstruktor. Tworzy obiekt użytkownika i dodaje go do listy wszystkich użytkowników.
+ * @brief Konstruktor. Tworzy uchwyt użytkownika o podanym ID; nie zmienia listy użytkowników.
+ * @param id ID użytkownika w statycznym magazynie.
+ */
+User::User(ParticipantStore::Id id) : id(id)
+{
+}
+
+/**
+ * @brief Dodaje nowego użytkownika na końcu listy wszystkich użytkowników.
  * @param firstName Imię użytkownika.
  * @param lastName Nazwisko użytkownika.
  * @param personGender Płeć użytkownika. Domyślną wartością jest gender::man.
  * @param score Wynik użytkownika. Domyślną wartością jest 0.
- * @warning Nie należy tworzyć obiektów typu User w celu innym, niż dodanie nowego użytkownika w programie. Takie zachowanie prowadzi do powstawania
- * duplikatów w statycznej liście użytkowników.
+ * @return Uchwyt nowego użytkownika.
  * @author Jarosław Tomczyński
  */
-User::User(const QString &firstName,const QString &lastName, gender personGender=man,double score=0.0)
+User User::addUser(const QString &firstName,const QString &lastName, gender personGender,double score)
+{
+    return User(registeredUsers.add(firstName, lastName, personGender, score));
+}
+
+/**
+ * @brief Zwraca indeks użytkownika w statycznej liście.
+ * @return Indeks użytkownika.
+ * @throw std::logic_error Jeśli użytkownika nie ma już na liście (np. po imporcie nowej listy).
+ */
+int User::index() const
 {
-    this->firstName = firstName;
-    this->lastName = lastName;
-    this->personGender=personGender;
-    this->shoutScore=score;
-    User::registeredUsers.append(*this);
+    int position = registeredUsers.indexOf(id);
+    if (position < 0)
+        throw std::logic_error("Użytkownika nie ma na liście.");
+    return position;
 }
 
 /**
  * @brief Zwraca poziom krzyku użytkownika.
  * @return Poziom krzyku użytkownika.
+ * @throw std::logic_error Jeśli użytkownika nie ma już na liście.
  * @author Jarosław Tomczyński
  */
-double User::getShoutScore()
+double User::getShoutScore() const
 {
-    return shoutScore;
+    return registeredUsers.score(index());
 }
 
 /**
  * @brief Zwraca imię użytkownika.
  * @return Imię użytkownika.
+ * @throw std::logic_error Jeśli użytkownika nie ma już na liście.
  * @author Jarosław Tomczyński
  */
-QString User::getFirstName()
+QString User::getFirstName() const
 {
-    return firstName;
+    return registeredUsers.firstName(index());
 }
 
 /**
  * @brief Zwraca nazwisko użytkownika.
  * @return Nazwisko użytkownika.
+ * @throw std::logic_error Jeśli użytkownika nie ma już na liście.
  * @author Jarosław Tomczyński
  */
-QString User::getLastName()
+QString User::getLastName() const
 {
-    return lastName;
+    return registeredUsers.lastName(index());
 }
 
 /**
  * @brief Zwraca płeć użytkownika.
  * @return Płeć użytkownika. Możliwe wartości: gender::man, gender::woman.
+ * @throw std::logic_error Jeśli użytkownika nie ma już na liście.
  * @author Jarosław Tomczyński
  */
-gender User::getPersonGender()
+gender User::getPersonGender() const
 {
-    return personGender;
+    return registeredUsers.personGender(index());
 }
 
 /**
@@ -69,12 +89,7 @@ gender User::getPersonGender()
  */
 void User::setShoutScore(int id,double score)
 {
-    if (id<0 || id>registeredUsers.size())
-    {
-        throw std::logic_error("Indeks poza zakresem listy.");
-        return;
-    }
-    registeredUsers[id].shoutScore=score;
+    registeredUsers.setScore(id, score);
 }
 
 /**
@@ -95,8 +110,8 @@ void User::exportToCSV(const QString &fileName)
    QFile file(filename);
    if (file.open(QIODevice::ReadWrite  | QIODevice::Truncate)) {
        QTextStream stream(&file);
-       foreach (User u, User::registeredUsers) {
-            stream << u.firstName<<";"<<u.lastName<<";"<<u.personGender<<";"<<QString::number(u.shoutScore) <<""<< endl;
+       for (int i = 0; i < registeredUsers.size(); ++i) {
+            stream << registeredUsers.firstName(i)<<";"<<registeredUsers.lastName(i)<<";"<<registeredUsers.personGender(i)<<";"<<QString::number(registeredUsers.score(i)) <<""<< endl;
        }
    }else{
        throw std::logic_error("Nie udało się utworzyć pliku. Upewnij się, że masz odpowiednie uprawnienia.");
@@ -111,12 +126,12 @@ void User::exportToCSV(const QString &fileName)
  * @brief Pobiera dane o użytkownikach z pliku CSV i dodaje ich do statycznej listy użytkowników.
  * @warning Usuwa wszystkich znajdujących się wcześniej na liście użytkowników.
  * @param fileName Nazwa pliku z rozszerzeniem csv.
- * @return Zwraca listę wskaźników na typ User, zawierającą adresy wstawionych do statycznej listy użytkowników.
+ * @return Zwraca listę uchwytów wstawionych do statycznej listy użytkowników, w kolejności z pliku.
  * @throw std::logic_error Jeśli użytkownik nie ma uprawnień do otwarcia pliku lub z powodu innego błędu uniemożliwiającego otwarcie
  * pliku.
  * @author Jarosław Tomczyński
  */
-QList<User*> User::importFromCSV(const QString &fileName)
+QList<User> User::importFromCSV(const QString &fileName)
 {
     registeredUsers.clear();
 
@@ -125,7 +140,7 @@ QList<User*> User::importFromCSV(const QString &fileName)
         throw std::logic_error("Nie udało się utworzyć pliku. Upewnij się, że masz odpowiednie uprawnienia.");
     }
     QTextStream in(&file);
-    QList<User*> list;
+    QList<User> list;
     while(!in.atEnd()) {
         QString line = in.readLine();
         QStringList fields = line.split(";");
@@ -133,28 +148,64 @@ QList<User*> User::importFromCSV(const QString &fileName)
         QString lastName = fields.at(1);
         gender personGender = (gender) fields.at(2).toInt();
         double score = fields.at(3).toDouble();
-        User user(firstName,lastName,personGender,score);
-        list.append(&registeredUsers.back());
+        list.append(addUser(firstName,lastName,personGender,score));
     }
     file.close();
     return list;
 }
 
 /**
- * @brief Zwraca adres obiektu User znajdującego się w określonym indeksie w statycznej liście.
- * @param id Indeks użytkownika w statycznej liście użytkowników.
- * @return Adres obiektu User.
+ * @brief Zwraca uchwyt użytkownika znajdującego się w określonym indeksie w statycznej liście.
+ * @param index Indeks użytkownika w statycznej liście użytkowników.
+ * @return Uchwyt użytkownika; pozostaje ważny po dodaniu kolejnych użytkowników.
  * @throw std::logic_error Jeśli indeks jest mniejszy od 0 lub równy/większy do rozmiaru listy.
  * @author Marcin Anuszkiewicz
  */
-User *User::GetUser(int index)
+User User::GetUser(int index)
 {
-    if (index<0 || index>registeredUsers.size())
-    {
-        throw std::logic_error("Indeks poza zakresem listy.");
-        return nullptr;
-    }
-    return &User::registeredUsers[index];
+    return User(registeredUsers.idAt(index));
+}
+
+/**
+ * @brief Zwraca indeks użytkownika o podanym trwałym ID w statycznej liście.
+ * @param id ID użytkownika.
+ * @return Indeks użytkownika lub -1, jeśli go już nie ma (np. po imporcie nowej listy).
+ */
+int User::indexOf(ParticipantStore::Id id)
+{
+    return registeredUsers.indexOf(id);
+}
+
+/**
+ * @brief Zwraca liczbę użytkowników w statycznej liście.
+ * @return Liczba zarejestrowanych użytkowników.
+ */
+int User::count()
+{
+    return registeredUsers.size();
+}
+
+/**
+ * @brief Zwraca użytkowników o podanym imieniu i nazwisku (wyszukiwanie w indeksie, bez przeglądania listy).
+ * @param firstName Imię użytkownika.
+ * @param lastName Nazwisko użytkownika.
+ * @return Uchwyty pasujących użytkowników.
+ */
+QList<User> User::findUsers(const QString &firstName, const QString &lastName)
+{
+    QList<User> users;
+    for (ParticipantStore::Id id : registeredUsers.find(firstName, lastName))
+        users.append(User(id));
+    return users;
+}
+
+/**
+ * @brief Zwraca trwałe ID użytkownika, które nie zmienia się przy dodawaniu innych użytkowników.
+ * @return ID użytkownika.
+ */
+ParticipantStore::Id User::getId() const
+{
+    return id;
 }
 
 /**
@@ -163,13 +214,11 @@ User *User::GetUser(int index)
  * @param firstName Imię użytkownika.
  * @param lastName Nazwisko użytkownika.
  * @param personGender Płeć użytkownika.
+ * @throw std::logic_error Jeśli indeks jest mniejszy od 0 lub równy/większy do rozmiaru listy.
  * @author Jarosław Tomczyński
  */
 void User::editUser(int ID, const QString &firstName, const QString &lastName, gender personGender)
 {
-    User &u = User::registeredUsers[ID];
-    u.firstName = firstName;
-    u.lastName = lastName;
-    u.personGender = personGender;
+    registeredUsers.edit(ID, firstName, lastName, personGender);
 }
 
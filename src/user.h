@@ -5,31 +5,34 @@
 #include <QTextStream>
 #include <exception>
 #include <stdexcept>
-
-enum gender {woman,man};
+#include "participantstore.h"
 
 /**
- * @brief Klasa określająca użytkownika i zarządzająca listą wszystkich zarejestrowanych użytkowników. Lista jest statycznym polem klasy.
+ * @brief Klasa określająca użytkownika i zarządzająca listą wszystkich zarejestrowanych użytkowników. Lista jest statycznym magazynem
+ * ParticipantStore, a obiekt User jest lekkim uchwytem przechowującym tylko trwałe ID użytkownika, więc można go kopiować i zapamiętywać.
  * @authors Jarosław Tomczyński Marcin Anuszkiewicz
  */
 class User
 {
-        static QList<User> registeredUsers;
-        QString firstName;
-        QString lastName;
-        gender personGender;
-        double shoutScore;
+        static ParticipantStore registeredUsers;
+        ParticipantStore::Id id;
+        explicit User(ParticipantStore::Id id);
+        int index() const;
     public:
-        User(const QString &firstName,const QString &lastName, gender gender,double score);
+        static User addUser(const QString &firstName,const QString &lastName, gender personGender=man,double score=0.0);
         static void editUser(int ID,const QString &firstName, const QString &lastName, gender personGender);
         static void setShoutScore(int id,double score);
-        double getShoutScore();
-        QString getFirstName();
-        QString getLastName();
-        gender getPersonGender();
+        double getShoutScore() const;
+        QString getFirstName() const;
+        QString getLastName() const;
+        gender getPersonGender() const;
+        ParticipantStore::Id getId() const;
         static void exportToCSV(const QString &fileName);
-        static QList<User*> importFromCSV(const QString &fileName);
-        static User* GetUser(int index);
+        static QList<User> importFromCSV(const QString &fileName);
+        static User GetUser(int index);
+        static int indexOf(ParticipantStore::Id id);
+        static QList<User> findUsers(const QString &firstName, const QString &lastName);
+        static int count();
 };
 
 #endif // USER_H
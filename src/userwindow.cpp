@@ -2,7 +2,7 @@
 #include "ui_userwindow.h"
 #include <QDesktopWidget>
 #include <QHeaderView>
-#include <QTableWidget>
+#include <QTableView>
 /**
  * @brief Konstruktor. Tworzy okno dostępne dla publiczności.
  * @param parent Okno nadrzędne.
@@ -21,13 +21,10 @@ UserWindow::UserWindow(QWidget *parent) :
     this->showMaximized(); //fullscreen
     //na środku UserList
     setCentralWidget(ui->UserList);
-    ui->UserList->setColumnCount(5); //liczba kolumn
-    ui->UserList->setColumnHidden(3, true); // Hide ID column.
-    ui->UserList->setColumnHidden(4, true); // Hide gender column.
-    QStringList Header; //nagłówek
-    Header << "Imię" << "Nazwisko" << "Wynik [dB]";
-    ui->UserList->setHorizontalHeaderLabels(Header);
-    Showing = a; // zmienna kontrolna wyswietlająca wszystkich niezależnie od płci
+    //kolejność trzyma model, a stała wysokość wierszy oszczędza mierzenia wszystkich rzędów
+    ranking = new RankingModel(this);
+    ui->UserList->setModel(ranking);
+    ui->UserList->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 }
 /**
  * @brief Destruktor. Niszczy okno dostępne dla publiczności.
@@ -51,61 +48,14 @@ void UserWindow::resizeEvent(QResizeEvent *event)
     QMainWindow::resizeEvent(event);
 }
 /**
- * @brief Metoda dodająca użytkownika do rankingu.
+ * @brief Metoda dodająca użytkownika do rankingu albo aktualizująca jego dane i wynik, jeśli już w nim jest.
  * @param user Uczestnik konkursu.
- * @param ID ID uczestnika konkursu.
+ * @param ID Trwałe ID uczestnika konkursu (User::getId()), niezależne od wiersza na liście prowadzącego.
  * @authors Marcin Anuszkiewicz Sebastian Zyśk Dariusz Jóźko Kamil Wasilewski
  */
-void UserWindow::InsertUserToRanking(User *user, int ID)
+void UserWindow::InsertUserToRanking(const User &user, ParticipantStore::Id ID)
 {
-    //dla każdego rzędu
-     for(int i=0;i<ui->UserList->rowCount();i++)
-     {
-         //edycja istniejącego użytkownika
-         if (ui->UserList->item(i,3)->text() == QString::number(ID))
-         {
-             ui->UserList->setItem(i,0,new QTableWidgetItem(user->getFirstName())); //dodajemy imie
-             ui->UserList->setItem(i,1,new QTableWidgetItem(user->getLastName())); //dodajemy nazwisko
-             auto item = new QTableWidgetItem();
-             item->setData(Qt::DisplayRole, QVariant(user->getShoutScore())); //dodajemy wynik
-             ui->UserList->setItem(i,2,item);
-             QString genderText = user->getPersonGender() == man ? "M" : "K";
-             ui->UserList->setItem(ui->UserList->rowCount()-1,4,new QTableWidgetItem(genderText)); //dodajemy płeć
-             ui->UserList->sortByColumn(2); //sortujemy listę po wyniku
-             if(Showing == w) //wyświetlanie kobiet
-			 {
-				 ShowAll();
-				 HideMen();
-			 }
-             else if(Showing == m) //wyświetlanie mężczyzn
-			 {
-				 ShowAll();
-				 HideWomen();
-			 }
-             return;
-         }
-     }
-     //dodawanie nowego użytkownika
-     ui->UserList->setRowCount(ui->UserList->rowCount()+1); //zwiększamy liczbę rzędów
-     ui->UserList->setItem(ui->UserList->rowCount()-1,0,new QTableWidgetItem(user->getFirstName())); //imie
-     ui->UserList->setItem(ui->UserList->rowCount()-1,1,new QTableWidgetItem(user->getLastName())); //nazwisko
-     auto item = new QTableWidgetItem();
-     item->setData(Qt::DisplayRole, QVariant(user->getShoutScore())); // wynik
-     ui->UserList->setItem(ui->UserList->rowCount()-1,2,item);
-     ui->UserList->setItem(ui->UserList->rowCount()-1,3,new QTableWidgetItem(QString::number(ID))); //ukryte ID
-     QString genderText = user->getPersonGender() == man ? "M" : "K";
-     ui->UserList->setItem(ui->UserList->rowCount()-1,4,new QTableWidgetItem(genderText)); //płeć
-     ui->UserList->sortByColumn(2);
-     if(Showing == w)
-     {
-         ShowAll();
-         HideMen();
-     }
-     else if(Showing == m)
-     {
-         ShowAll();
-         HideWomen();
-     }
+    ranking->setParticipant(ID, user.getFirstName(), user.getLastName(), user.getPersonGender(), user.getShoutScore());
 }
 /**
  * @brief Metoda czyszcząca zawartość rankingu.
@@ -113,59 +63,17 @@ void UserWindow::InsertUserToRanking(User *user, int ID)
  */
 void UserWindow::ClearRanking()
 {
-    ui->UserList->clearContents();
-    ui->UserList->setRowCount(0); //zmniejszamy liczbę rzędów do 0
+    ranking->clear();
 }
 /**
- * @brief Metoda umożliwiająca kontrolę wyświetlania uczestników według płci przy pomocy zmiennej Showing.
- * @param Showing Zmienna kontrolna.
+ * @brief Metoda wybierająca uczestników wyświetlanych w rankingu według płci.
+ * @param Showing Wyświetlana grupa uczestników.
  * @authors Sebastian Zyśk Dariusz Jóźko
  */
 void UserWindow::SetShowing(showing Showing)
 {
-    this->Showing=Showing;
+    if (Showing == a)
+        ranking->setFilter(RankingCategory::all());
+    else
+        ranking->setFilter(RankingCategory::ofGender(Showing == m ? man : woman));
 }
-/**
- * @brief Metoda ukrywająca wszystkich mężczyzn w rankingu.
- * @authors Sebastian Zyśk Dariusz Jóźko
- */
-void UserWindow::HideMen()
-{
-    for(int i=0;i<ui->UserList->rowCount();i++)
-    {
-        if(ui->UserList->item(i,4)->text()=="M")
-        {
-            ui->UserList->setRowHidden(i,true);
-        }
-    }
-}
-/**
- * @brief Metoda ukrywająca wszystkie kobiety w rankingu.
- * @authors Sebastian Zyśk Dariusz Jóźko
- */
-void UserWindow::HideWomen()
-{
-    for(int i=0;i<ui->UserList->rowCount();i++)
-    {
-        if(ui->UserList->item(i,4)->text()=="K")
-        {
-            ui->UserList->setRowHidden(i,true);
-        }
-    }
-}
-/**
- * @brief Metoda wyświetlająca wszystkich uczestników konkursu w rankingu.
- * @authors Sebastian Zyśk Dariusz Jóźko
- */
-void UserWindow::ShowAll()
-{
-    for(int i=0;i<ui->UserList->rowCount();i++)
-    {
-        ui->UserList->setRowHidden(i,false);
-    }
-}
-
-
-
-
-
@@ -1,6 +1,7 @@
 #ifndef USERWINDOW_H
 #define USERWINDOW_H
 
+#include "rankingmodel.h"
 #include "user.h"
 #include <QMainWindow>
 
@@ -21,16 +22,13 @@ public:
     explicit UserWindow(QWidget *parent = 0);
     ~UserWindow();
     void resizeEvent(QResizeEvent *event) override;
-    void InsertUserToRanking(User *user,int ID);
+    void InsertUserToRanking(const User &user, ParticipantStore::Id ID);
     void ClearRanking();
     void SetShowing(showing Showing);
-    void HideMen();
-    void HideWomen();
-    void ShowAll();
 
 private:
     Ui::UserWindow *ui;
-    showing Showing;
+    RankingModel *ranking;
 };
 
 #endif // USERWINDOW_H
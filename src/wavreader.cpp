@@ -0,0 +1,242 @@
+#include "wavreader.h"
+#include "compressedaudiofile.h"
+#include "losslesscodec.h"
+#include "pcmconverter.h"
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+using std::logic_error;
+
+/**
+ * @brief Kody formatu z fragmentu fmt.
+ */
+static const quint16 formatPcm = 0x0001;
+static const quint16 formatFloat = 0x0003;
+static const quint16 formatExtensible = 0xFFFE;
+
+/**
+ * @brief Konstruktor. Plik otwierany jest dopiero przez open().
+ * @param fileName Nazwa pliku.
+ */
+WavReader::WavReader(const QString &fileName) : file(fileName), mapped(nullptr), samples(nullptr), rate(0), channels(0),
+	sampleEncoding(Pcm16), frameCount(0), frameBytes(0), fileBegin(nullptr), blockOffsets(nullptr), blockCount(0), blockFrames(0),
+	blocksEnd(0), decodedBlock(-1)
+{
+}
+/**
+ * @brief Destruktor. Zwalnia mapowanie i zamyka plik.
+ */
+WavReader::~WavReader()
+{
+	if (mapped != nullptr)
+		file.unmap(mapped);
+}
+/**
+ * @brief Metoda otwierająca i mapująca plik oraz odczytująca jego fragmenty. Jeśli mapowanie nie jest możliwe, plik jest wczytywany do pamięci.
+ * @throw std::logic_error Jeśli pliku nie można otworzyć, nie jest plikiem WAV lub ma nieobsługiwany format.
+ */
+void WavReader::open()
+{
+	if (!file.open(QFile::ReadOnly))
+		throw logic_error("Nie udało się otworzyć pliku. Upewnij się, że masz odpowiednie uprawnienia.");
+	const qint64 length = file.size();
+	const uchar *begin = mapped = file.map(0, length);
+	if (begin == nullptr)
+	{
+		contents = file.readAll();
+		file.close();
+		begin = reinterpret_cast<const uchar *>(contents.constData());
+	}
+
+	fileBegin = begin;
+	if (length >= CompressedAudioFile::headerSize && std::memcmp(begin, "KKA1", 4) == 0)
+	{
+		parseCompressed(length);
+		return;
+	}
+
+	const uchar *end = begin + length;
+	if (length < 12 || std::memcmp(begin, "RIFF", 4) != 0 || std::memcmp(begin + 8, "WAVE", 4) != 0)
+		throw logic_error("Plik nie jest plikiem WAV.");
+
+	bool hasFormat = false;
+	// Chunks: 4 byte id, 4 byte size, data padded to an even length. Unknown chunks (LIST, fact, ...) are skipped.
+	for (const uchar *chunk = begin + 12; end - chunk >= 8; )
+	{
+		const quint32 size = qFromLittleEndian<quint32>(chunk + 4);
+		const uchar *body = chunk + 8;
+		const qint64 available = end - body;
+		if (std::memcmp(chunk, "fmt ", 4) == 0)
+		{
+			if (size > available)
+				throw logic_error("Uszkodzony nagłówek pliku WAV.");
+			parseFormat(body, size);
+			hasFormat = true;
+		}
+		else if (std::memcmp(chunk, "data", 4) == 0)
+		{
+			if (!hasFormat)
+				throw logic_error("Uszkodzony nagłówek pliku WAV.");
+			// Recorders that were interrupted leave 0 or 0xFFFFFFFF here, so trust the file size instead.
+			const qint64 bytes = (size == 0 || size > available) ? available : size;
+			samples = body;
+			frameCount = (int) (bytes / frameBytes);
+			return;
+		}
+		if (size > available)
+			break;
+		chunk = body + size + (size & 1);
+	}
+	throw logic_error("Plik WAV nie zawiera danych.");
+}
+/**
+ * @brief Metoda odczytująca fragment fmt.
+ * @param chunk Zawartość fragmentu.
+ * @param size Rozmiar fragmentu w bajtach.
+ * @throw std::logic_error Jeśli format nie jest obsługiwany.
+ */
+void WavReader::parseFormat(const uchar *chunk, quint32 size)
+{
+	if (size < 16)
+		throw logic_error("Uszkodzony nagłówek pliku WAV.");
+	quint16 format = qFromLittleEndian<quint16>(chunk);
+	channels = qFromLittleEndian<quint16>(chunk + 2);
+	rate = (int) qFromLittleEndian<quint32>(chunk + 4);
+	const int bits = qFromLittleEndian<quint16>(chunk + 14);
+	// WAVE_FORMAT_EXTENSIBLE keeps the actual format in the first two bytes of the sub-format GUID.
+	if (format == formatExtensible && size >= 26)
+		format = qFromLittleEndian<quint16>(chunk + 24);
+
+	if (channels < 1 || channels > 2 || rate <= 0)
+		throw logic_error("Obsługiwane są tylko pliki WAV mono i stereo.");
+	if (format == formatPcm && bits == 16)
+		sampleEncoding = Pcm16;
+	else if (format == formatPcm && bits == 24)
+		sampleEncoding = Pcm24;
+	else if (format == formatPcm && bits == 32)
+		sampleEncoding = Pcm32;
+	else if (format == formatFloat && bits == 32)
+		sampleEncoding = Float32;
+	else
+		throw logic_error("Obsługiwane są tylko pliki WAV PCM 16, 24, 32 bity i float 32 bity.");
+	frameBytes = channels * bits / 8;
+}
+/**
+ * @brief Metoda odczytująca nagłówek i indeks bloków archiwum skompresowanego.
+ * @param length Rozmiar pliku w bajtach.
+ * @throw std::logic_error Jeśli archiwum jest uszkodzone lub ma nieobsługiwany format.
+ */
+void WavReader::parseCompressed(qint64 length)
+{
+	rate = (int) qFromLittleEndian<quint32>(fileBegin + 4);
+	channels = qFromLittleEndian<quint16>(fileBegin + 8);
+	const int bits = qFromLittleEndian<quint16>(fileBegin + 10);
+	blockFrames = (int) qFromLittleEndian<quint32>(fileBegin + 12);
+	const quint64 total = qFromLittleEndian<quint64>(fileBegin + 16);
+	blocksEnd = qFromLittleEndian<quint64>(fileBegin + 24);
+	if (channels != 1 || bits != 16 || rate <= 0 || blockFrames <= 0 || blocksEnd < (quint64) CompressedAudioFile::headerSize
+			|| blocksEnd + 4 > (quint64) length || total > (quint64) std::numeric_limits<int>::max())
+		throw logic_error("Uszkodzone archiwum nagrania.");
+	blockCount = (int) qFromLittleEndian<quint32>(fileBegin + blocksEnd);
+	if ((quint64) blockCount != (total + blockFrames - 1) / blockFrames || blocksEnd + 4 + 8 * (quint64) blockCount > (quint64) length)
+		throw logic_error("Uszkodzone archiwum nagrania.");
+	blockOffsets = fileBegin + blocksEnd + 4;
+	quint64 previous = CompressedAudioFile::headerSize;
+	for (int i = 0; i < blockCount; ++i)
+	{
+		const quint64 offset = qFromLittleEndian<quint64>(blockOffsets + 8 * i);
+		if (offset < previous || offset > blocksEnd)
+			throw logic_error("Uszkodzone archiwum nagrania.");
+		previous = offset;
+	}
+	sampleEncoding = Pcm16;
+	frameBytes = (int) sizeof(qint16);
+	frameCount = (int) total;
+	decoded.resize(blockFrames);
+}
+/**
+ * @brief Metoda dekodująca blok archiwum skompresowanego. Ostatnio zdekodowany blok jest zapamiętywany.
+ * @param block Numer bloku.
+ * @return Próbki bloku.
+ */
+const qint16 *WavReader::decodeBlock(int block) const
+{
+	if (block != decodedBlock)
+	{
+		const quint64 begin = qFromLittleEndian<quint64>(blockOffsets + 8 * block);
+		const quint64 end = block + 1 < blockCount ? qFromLittleEndian<quint64>(blockOffsets + 8 * (block + 1)) : blocksEnd;
+		const int count = qMin(blockFrames, frameCount - block * blockFrames);
+		if (!LosslessCodec::decodeBlock(fileBegin + begin, (int) (end - begin), decoded.data(), count))
+		{
+			qDebug() << "Corrupted archive block" << block << "in" << file.fileName();
+			decoded.fill(0);
+		}
+		decodedBlock = block;
+	}
+	return decoded.constData();
+}
+/**
+ * @brief Metoda zamieniająca ramki na próbki w zakresie [-1,1]. Kanały pliku stereo są uśredniane.
+ * @param frame Numer pierwszej ramki.
+ * @param count Liczba ramek.
+ * @param out Bufor wyjściowy na count próbek.
+ */
+void WavReader::read(int frame, int count, Sample *out) const
+{
+	if (isCompressed())
+	{
+		// Only the blocks overlapping the requested range are decoded.
+		while (count > 0)
+		{
+			const int block = frame / blockFrames;
+			const int offset = frame - block * blockFrames;
+			const int n = qMin(count, blockFrames - offset);
+			const qint16 *x = decodeBlock(block) + offset;
+			for (int i = 0; i < n; ++i)
+				out[i] = (Sample) x[i] / (Sample) std::numeric_limits<short>::max();
+			out += n;
+			frame += n;
+			count -= n;
+		}
+		return;
+	}
+	const uchar *in = samples + (qint64) frame * frameBytes;
+	if (sampleEncoding == Pcm16 && channels == 1)
+	{
+		PcmConverter::convert(in, out, count);
+		return;
+	}
+	const int step = frameBytes / channels;
+	for (int i = 0; i < count; ++i)
+	{
+		double sum = 0.0;
+		for (int c = 0; c < channels; ++c, in += step)
+		{
+			switch (sampleEncoding)
+			{
+			case Pcm16:
+				sum += qFromLittleEndian<qint16>(in) / 32767.0;
+				break;
+			case Pcm24:
+				// Place the sample in the upper 24 bits of a 32-bit word so that it keeps its sign.
+				sum += (qint32) ((quint32) in[0] << 8 | (quint32) in[1] << 16 | (quint32) in[2] << 24) / 2147483392.0;
+				break;
+			case Pcm32:
+				sum += qFromLittleEndian<qint32>(in) / 2147483647.0;
+				break;
+			case Float32:
+			{
+				const quint32 bits = qFromLittleEndian<quint32>(in);
+				float value;
+				std::memcpy(&value, &bits, sizeof(value));
+				sum += value;
+				break;
+			}
+			}
+		}
+		out[i] = (Sample) (sum / channels);
+	}
+}
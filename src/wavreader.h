@@ -0,0 +1,101 @@
+#ifndef WAVREADER_H
+#define WAVREADER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include "audiomodel.h"
+
+/**
+ * @brief Klasa czytająca pliki WAV bez kopiowania danych: plik jest mapowany do pamięci, a fragment danych udostępniany jako widok.
+ * Nagłówek nie musi mieć 44 bajtów; kolejne fragmenty RIFF (fmt, LIST, fact, data i inne) są przeglądane po kolei.
+ * Obsługiwane są próbki PCM 16, 24 i 32 bity oraz float 32 bity (także w formacie WAVE_FORMAT_EXTENSIBLE), mono i stereo.
+ * Czyta też archiwa skompresowane bezstratnie (CompressedAudioFile); wtedy dekodowane są tylko bloki potrzebne do odczytu.
+ */
+class WavReader
+{
+public:
+	/**
+	 * @brief Format próbek w pliku.
+	 */
+	enum Encoding
+	{
+		Pcm16, /**< Liczby całkowite ze znakiem, 16 bitów. */
+		Pcm24, /**< Liczby całkowite ze znakiem, 24 bity. */
+		Pcm32, /**< Liczby całkowite ze znakiem, 32 bity. */
+		Float32 /**< Liczby zmiennoprzecinkowe IEEE 754, 32 bity. */
+	};
+
+	explicit WavReader(const QString &fileName);
+	~WavReader();
+	void open();
+	void read(int frame, int count, Sample *out) const;
+
+	/**
+	 * @brief Zwraca częstotliwość próbkowania.
+	 * @return Częstotliwość próbkowania w Hz.
+	 */
+	int sampleRate() const { return rate; }
+	/**
+	 * @brief Zwraca liczbę kanałów (1 lub 2).
+	 * @return Liczba kanałów.
+	 */
+	int channelCount() const { return channels; }
+	/**
+	 * @brief Zwraca format próbek.
+	 * @return Format próbek.
+	 */
+	Encoding encoding() const { return sampleEncoding; }
+	/**
+	 * @brief Zwraca liczbę ramek (próbek jednego kanału).
+	 * @return Liczba ramek.
+	 */
+	int frames() const { return frameCount; }
+	/**
+	 * @brief Zwraca liczbę bajtów jednej ramki (wszystkich kanałów).
+	 * @return Liczba bajtów.
+	 */
+	int bytesPerFrame() const { return frameBytes; }
+	/**
+	 * @brief Zwraca widok fragmentu danych, ważny do zniszczenia obiektu.
+	 * @return Początek danych (frames() * bytesPerFrame() bajtów, little endian, kanały z przeplotem) lub nullptr dla archiwum
+	 * skompresowanego (isCompressed()).
+	 */
+	const uchar *data() const { return samples; }
+	/**
+	 * @brief Zwraca, czy plik jest archiwum skompresowanym.
+	 * @return Czy dane są dekodowane blokami.
+	 */
+	bool isCompressed() const { return blockOffsets != nullptr; }
+
+private:
+	QFile file;
+	uchar *mapped;
+	QByteArray contents;
+	const uchar *samples;
+	int rate;
+	int channels;
+	Encoding sampleEncoding;
+	int frameCount;
+	int frameBytes;
+
+	const uchar *fileBegin;
+	const uchar *blockOffsets;
+	int blockCount;
+	int blockFrames;
+	quint64 blocksEnd;
+	mutable QVector<qint16> decoded;
+	mutable int decodedBlock;
+
+	void parseFormat(const uchar *chunk, quint32 size);
+	void parseCompressed(qint64 length);
+	const qint16 *decodeBlock(int block) const;
+	Q_DISABLE_COPY(WavReader)
+};
+
+Q_DECLARE_METATYPE(QSharedPointer<WavReader>)
+
+#endif // WAVREADER_H
@@ -0,0 +1,80 @@
+#include "weightingtable.h"
+#include <cmath>
+
+QHash<WeightingTable::Key, QSharedPointer<const WeightingTable> > WeightingTable::cache;
+QList<WeightingTable::Key> WeightingTable::recentlyUsed;
+QMutex WeightingTable::mutex;
+
+/**
+ * @brief Maksymalna liczba tablic przechowywanych jednocześnie w pamięci podręcznej.
+ */
+static const int maxCachedTables = 8;
+
+/**
+ * @brief Konstruktor. Wylicza wagi wszystkich prążków widma jednostronnego.
+ * @param sampleRate Częstotliwość próbkowania w Hz.
+ * @param size Liczba próbek transformaty.
+ * @param response Krzywa korekcji urządzenia; pusty wskaźnik, jeśli wagi mają zawierać tylko charakterystykę A.
+ */
+WeightingTable::WeightingTable(int sampleRate, int size, const QSharedPointer<const FrequencyResponse> &response) : weights(size / 2 + 1),
+	floatWeights(size / 2 + 1), rate(sampleRate), length(size), correction(response)
+{
+	// Parseval: sum |x[n]|^2 = (1 / N) sum |X[k]|^2.
+	const double scale = 1.0 / (double) size;
+	for (int i = 0; i < weights.length(); ++i)
+	{
+		const double frequency = (double) i * sampleRate / size;
+		double gain = gainA(frequency);
+		double w = gain * gain * scale;
+		if (!response.isNull())
+			w *= response->gain(frequency);
+		// Every bin except DC and Nyquist stands for a pair of bins of the two-sided spectrum.
+		if (i != 0 && !(size % 2 == 0 && i == size / 2))
+			w *= 2;
+		weights[i] = w;
+		floatWeights[i] = (float) w;
+	}
+}
+/**
+ * @brief Zwraca tablicę wag dla podanej częstotliwości próbkowania, rozmiaru transformaty i krzywej korekcji, tworząc ją przy pierwszym użyciu.
+ * @param sampleRate Częstotliwość próbkowania w Hz.
+ * @param size Liczba próbek transformaty.
+ * @param response Krzywa korekcji urządzenia; pusty wskaźnik dla samej charakterystyki A.
+ * @return Współdzielona tablica wag.
+ */
+QSharedPointer<const WeightingTable> WeightingTable::get(int sampleRate, int size, const QSharedPointer<const FrequencyResponse> &response)
+{
+	QMutexLocker locker(&mutex);
+	const Key key(qMakePair(sampleRate, size), response.isNull() ? 0 : response->id());
+	QSharedPointer<const WeightingTable> table = cache.value(key);
+	if (table.isNull())
+	{
+		table = QSharedPointer<const WeightingTable>(new WeightingTable(sampleRate, size, response));
+		cache.insert(key, table);
+		// Attempts may still differ in length, so keep only the most recently used tables.
+		if (recentlyUsed.size() >= maxCachedTables)
+			cache.remove(recentlyUsed.takeFirst());
+	}
+	else
+		recentlyUsed.removeOne(key);
+	recentlyUsed.append(key);
+	return table;
+}
+/**
+ * @brief Metoda obliczająca wzmocnienie charakterystyki A według IEC 61672, unormowane do 0 dB przy 1 kHz.
+ * @param frequency Częstotliwość w Hz.
+ * @return Wzmocnienie amplitudy (nie w dB).
+ */
+double WeightingTable::gainA(double frequency)
+{
+	const double c1 = 12194.217 * 12194.217;
+	const double c2 = 20.598997 * 20.598997;
+	const double c3 = 107.65265 * 107.65265;
+	const double c4 = 737.86223 * 737.86223;
+	auto response = [=](double frequency) {
+		double f = frequency * frequency;
+		return f * f * c1 / ((f + c2) * std::sqrt((f + c3) * (f + c4)) * (f + c1));
+	};
+	static const double normalisation = 1.0 / response(1000.0);
+	return response(frequency) * normalisation;
+}
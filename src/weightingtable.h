@@ -0,0 +1,75 @@
+#ifndef WEIGHTINGTABLE_H
+#define WEIGHTINGTABLE_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QSharedPointer>
+#include <QVector>
+#include "frequencyresponse.h"
+
+/**
+ * @brief Tablica wag charakterystyki A (IEC 61672) dla prążków widma o danej częstotliwości próbkowania i rozmiarze transformaty.
+ * Waga prążka zawiera kwadrat wzmocnienia charakterystyki A dla rzeczywistej częstotliwości prążka (i * f / N), podwojenie
+ * prążków widma jednostronnego oraz skalowanie twierdzenia Parsevala, więc suma wag pomnożonych przez |X[i]|^2 daje od razu
+ * energię sygnału z charakterystyką A. Jeśli podano krzywą korekcji urządzenia (FrequencyResponse), wagi zawierają też jej poprawkę,
+ * więc korekcja charakterystyki i charakterystyka A stosowane są w tym samym mnożeniu. Tablice przechowywane są w pamięci podręcznej
+ * i współdzielone przez pomiary i kalibrację.
+ */
+class WeightingTable
+{
+public:
+	static QSharedPointer<const WeightingTable> get(int sampleRate, int size,
+													const QSharedPointer<const FrequencyResponse> &response = QSharedPointer<const FrequencyResponse>());
+	static double gainA(double frequency);
+
+	/**
+	 * @brief Zwraca wagi kolejnych prążków.
+	 * @return Tablica o długości bins().
+	 */
+	const double *data() const { return weights.constData(); }
+	/**
+	 * @brief Zwraca wagi kolejnych prążków w pojedynczej precyzji, dla AudioModel::frameEnergy(const float *, int, int).
+	 * @return Tablica o długości bins().
+	 */
+	const float *floatData() const { return floatWeights.constData(); }
+	/**
+	 * @brief Zwraca liczbę prążków widma jednostronnego (size / 2 + 1).
+	 * @return Liczba wag w tablicy.
+	 */
+	int bins() const { return weights.length(); }
+	/**
+	 * @brief Zwraca częstotliwość próbkowania, dla której wyliczono wagi.
+	 * @return Częstotliwość próbkowania w Hz.
+	 */
+	int sampleRate() const { return rate; }
+	/**
+	 * @brief Zwraca rozmiar transformaty, dla którego wyliczono wagi.
+	 * @return Liczba próbek transformaty.
+	 */
+	int size() const { return length; }
+	/**
+	 * @brief Zwraca krzywą korekcji uwzględnioną w wagach.
+	 * @return Krzywa korekcji; pusty wskaźnik, jeśli wagi zawierają tylko charakterystykę A.
+	 */
+	QSharedPointer<const FrequencyResponse> response() const { return correction; }
+
+private:
+	// Sample rate, size and FrequencyResponse::id() (0 without a correction).
+	typedef QPair<QPair<int, int>, int> Key;
+
+	QVector<double> weights;
+	QVector<float> floatWeights;
+	int rate;
+	int length;
+	QSharedPointer<const FrequencyResponse> correction;
+
+	static QHash<Key, QSharedPointer<const WeightingTable> > cache;
+	static QList<Key> recentlyUsed;
+	static QMutex mutex;
+
+	WeightingTable(int sampleRate, int size, const QSharedPointer<const FrequencyResponse> &response);
+};
+
+#endif // WEIGHTINGTABLE_H